@@ -0,0 +1,121 @@
+/* Times the icon kernels of the tabicons patch against a naive per pixel loop
+ * and checks that both agree. Run with "make bench". */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif // __SSE2__
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+static void premultiply(uint32_t *px, int n);
+#if defined(__AVX2__)
+static void premultiply8(uint32_t *px);
+#endif // __AVX2__
+#if defined(__SSE2__)
+static void premultiply4(uint32_t *px);
+#endif // __SSE2__
+static void scaleicon(const uint32_t *src, int sw, int sh, uint32_t *dst, int dw, int dh, int stride);
+
+#include "../patch/iconscale.c"
+
+/* what the kernels replace: premultiply and average in floating point */
+static void
+naive(const uint32_t *src, int sw, int sh, uint32_t *dst, int dw, int dh)
+{
+	int x, y, sx, sy, x0, x1, y0, y1, ch;
+	double s[4], a;
+	uint32_t px;
+
+	for (y = 0; y < dh; y++) {
+		y0 = y * sh / dh;
+		y1 = MAX(y0 + 1, (y + 1) * sh / dh);
+		for (x = 0; x < dw; x++) {
+			x0 = x * sw / dw;
+			x1 = MAX(x0 + 1, (x + 1) * sw / dw);
+			s[0] = s[1] = s[2] = s[3] = 0;
+			for (sy = y0; sy < y1; sy++) {
+				for (sx = x0; sx < x1; sx++) {
+					px = src[sy * sw + sx];
+					a = (px >> 24) / 255.0;
+					for (ch = 0; ch < 3; ch++)
+						s[ch] += ((px >> (ch * 8)) & 0xff) * a;
+					s[3] += px >> 24;
+				}
+			}
+			px = 0;
+			for (ch = 0; ch < 4; ch++)
+				px |= (uint32_t)(s[ch] / ((x1 - x0) * (y1 - y0)) + 0.5) << (ch * 8);
+			dst[y * dw + x] = px;
+		}
+	}
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int
+main(void)
+{
+	static const int sizes[][3] = {
+		/* source edge, bar height, iterations */
+		{ 256, 22, 2000 }, { 128, 22, 5000 }, { 64, 16, 20000 }, { 48, 30, 20000 },
+	};
+	uint32_t *src, *tmp, *a, *b;
+	int i, j, n, s, d, diff, maxdiff;
+	double t0, tnaive, tkernel;
+
+	srand(1);
+	printf("%-10s %12s %12s %8s %8s\n", "size", "naive us", "kernel us", "speedup", "maxdiff");
+	for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+		s = sizes[i][0];
+		d = sizes[i][1];
+		n = sizes[i][2];
+		src = malloc(s * s * sizeof(uint32_t));
+		tmp = malloc(s * s * sizeof(uint32_t));
+		a = malloc(d * d * sizeof(uint32_t));
+		b = malloc(d * d * sizeof(uint32_t));
+		for (j = 0; j < s * s; j++)
+			src[j] = (uint32_t)rand() << 1 ^ (uint32_t)rand();
+
+		t0 = now();
+		for (j = 0; j < n; j++)
+			naive(src, s, s, a, d, d);
+		tnaive = (now() - t0) / n * 1e6;
+
+		t0 = now();
+		for (j = 0; j < n; j++) {
+			for (diff = 0; diff < s * s; diff++)
+				tmp[diff] = src[diff];
+			premultiply(tmp, s * s);
+			scaleicon(tmp, s, s, b, d, d, d);
+		}
+		tkernel = (now() - t0) / n * 1e6;
+
+		/* both round per step, allow a difference of one per channel */
+		for (maxdiff = j = 0; j < d * d * 4; j++) {
+			diff = abs((int)(a[j / 4] >> (j % 4 * 8) & 0xff) - (int)(b[j / 4] >> (j % 4 * 8) & 0xff));
+			maxdiff = MAX(maxdiff, diff);
+		}
+		printf("%3d -> %-3d %12.2f %12.2f %7.1fx %8d\n", s, d, tnaive, tkernel,
+		       tnaive / tkernel, maxdiff);
+		free(src);
+		free(tmp);
+		free(a);
+		free(b);
+		if (maxdiff > 1)
+			return 1;
+	}
+
+	return 0;
+}
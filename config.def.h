@@ -8,15 +8,72 @@ static char *selbgcolor   = "#555555";
 static char *selfgcolor   = "#ffffff";
 static char *urgbgcolor   = "#111111";
 static char *urgfgcolor   = "#cc0000";
-static char before[]      = "<";
-static char after[]       = ">";
-static char titletrim[]   = "...";
+static char *before       = "<";
+static char *after        = ">";
+static char *titletrim    = "...";
 static int  tabwidth      = 200;
 static int  foreground    = 1;
 static int  urgentswitch  = 0;
 #if SEPARATOR_PATCH
 static int  separator     = 4;
 #endif // SEPARATOR_PATCH
+#if SIDEBAR_PATCH
+static int  sidebarwidth  = 200; /* tabs are listed in a column this wide */
+static int  sidebarright  = 0;   /* 1 puts the column on the right */
+#endif // SIDEBAR_PATCH
+#if FITTABS_PATCH
+static int  mintabwidth   = 80;  /* tabs are sized to their title within these */
+static int  maxtabwidth   = 300;
+#endif // FITTABS_PATCH
+
+#if FONTFALLBACK_PATCH
+/* tried in order for characters the font lacks, before asking fontconfig */
+static const char *fallbackfonts[] = {
+	"Noto Sans CJK JP:size=9",
+	"Noto Sans Symbols 2:size=9",
+};
+#endif // FONTFALLBACK_PATCH
+
+#if ICON_PATCH
+static int iconsize = 32;   /* preferred size of the _NET_WM_ICON image passed on to the WM */
+static int iconrate = 1000; /* minimum time in ms between icon fetches for a busy tab */
+#endif // ICON_PATCH
+
+#if ACTIVITY_PATCH
+static int activityrate = 1000; /* ms a tab that was left has to settle before its changes mark it */
+#endif // ACTIVITY_PATCH
+
+#if PROCSTATS_PATCH
+static int procrate = 2000; /* ms between samples of the cpu and memory usage of the tabs */
+#endif // PROCSTATS_PATCH
+
+#if SUPERVISE_PATCH
+static int orphantimeout  = 5000; /* ms a tab command may outlive its window before it is reported */
+static int killorphans    = 0;    /* 1 sends SIGTERM to such a command */
+static int restartcrashed = 0;    /* 1 spawns a tab again when its command crashed */
+static int restartdelay   = 500;  /* ms before the first restart, doubled for every crash in a row */
+#endif // SUPERVISE_PATCH
+
+#if OVERVIEW_PATCH
+static int thumbwidth = 320;  /* width of the cached thumbnail of every tab */
+static int thumbrate  = 1000; /* minimum time in ms between thumbnail updates of a background tab */
+#endif // OVERVIEW_PATCH
+
+#if EVENTPRIORITY_PATCH
+static int eventpriority = 1; /* 0 handles events in arrival order, to compare latencies */
+#endif // EVENTPRIORITY_PATCH
+
+#if DRAG_PATCH && POINTERCOMPRESS_PATCH
+static int dragrate = 10;  /* tab reorders per second while dragging, 0 only on release */
+#endif // DRAG_PATCH && POINTERCOMPRESS_PATCH
+
+#if FRAMEPACE_PATCH
+static int framerate = 60; /* bar redraws per second if RandR can not tell the refresh rate */
+#endif // FRAMEPACE_PATCH
+
+#if RASTER_PATCH
+static int rasterbar = 1;  /* 0 draws the bar with core X / Xft requests instead */
+#endif // RASTER_PATCH
 
 #if BAR_HEIGHT_PATCH
 static int barheight = 0;  /* 0 means derive by font (default), otherwise absolute height */
@@ -30,6 +87,18 @@ static int barheight = 0;  /* 0 means derive by font (default), otherwise absolu
 static int newposition  = 0;
 static int npisrelative = 0;
 
+#if IPC_PATCH
+/* control socket in $XDG_RUNTIME_DIR (/tmp if unset), %s is replaced by the
+ * window id of tabbed */
+static char *ipcsockpath = "tabbed-%s.sock";
+#endif // IPC_PATCH
+
+#if DAEMON_PATCH
+/* socket of tabbed -D in $XDG_RUNTIME_DIR (/tmp if unset), %s is replaced by
+ * $DISPLAY */
+static char *daemonsockpath = "tabbed-daemon%s.sock";
+#endif // DAEMON_PATCH
+
 #define SETPROP(p) { \
         .v = (char *[]){ "/bin/sh", "-c", \
                 "prop=\"`xwininfo -children -id $1 | grep '^     0x' |" \
@@ -81,6 +150,15 @@ static const Key keys[] = {
 	{ MODKEY|ShiftMask,     45,           movetab,     { .i = +1 } },
 	{ MODKEY,               23,           rotate,      { .i = 0 } },
 	{ MODKEY,               49,           spawn,       SETPROP("_TABBED_SELECT_TAB") },
+	#if SWITCHER_PATCH
+	{ MODKEY|ShiftMask,     49,           switcher,    { 0 } },
+	#endif // SWITCHER_PATCH
+	#if OVERVIEW_PATCH
+	{ MODKEY|ShiftMask,     32,           overview,    { 0 } },
+	#endif // OVERVIEW_PATCH
+	#if PROCSTATS_PATCH
+	{ MODKEY|ShiftMask,     33,           focusbusy,   { 0 } },
+	#endif // PROCSTATS_PATCH
 	{ MODKEY,               10,           move,        { .i = 0 } },
 	{ MODKEY,               11,           move,        { .i = 1 } },
 	{ MODKEY,               12,           move,        { .i = 2 } },
@@ -92,6 +170,12 @@ static const Key keys[] = {
 	{ MODKEY,               18,           move,        { .i = 8 } },
 	{ MODKEY,               19,           move,        { .i = 9 } },
 	{ MODKEY,               24,           killclient,  { 0 } },
+	#if BULKOPS_PATCH
+	{ MODKEY|ShiftMask,     24,           closeothers, { 0 } },
+	{ MODKEY|Mod1Mask,      24,           closeright,  { 0 } },
+	{ MODKEY|ShiftMask|Mod1Mask, 24,      closeall,    { 0 } },
+	{ MODKEY|ShiftMask,     40,           detachall,   { 0 } },
+	#endif // BULKOPS_PATCH
 	{ MODKEY,               30,           focusurgent, { .v = NULL } },
 	{ MODKEY|ShiftMask,     30,           toggle,      { .v = (void*) &urgentswitch } },
 	{ 0,                    95,           fullscreen,  { 0 } },
@@ -113,6 +197,15 @@ static const Key keys[] = {
 	{ MODKEY,               XK_Tab,       rotate,      { .i = 0 } },
 
 	{ MODKEY,               XK_grave,     spawn,       SETPROP("_TABBED_SELECT_TAB") },
+	#if SWITCHER_PATCH
+	{ MODKEY|ShiftMask,     XK_grave,     switcher,    { 0 } },
+	#endif // SWITCHER_PATCH
+	#if OVERVIEW_PATCH
+	{ MODKEY|ShiftMask,     XK_o,         overview,    { 0 } },
+	#endif // OVERVIEW_PATCH
+	#if PROCSTATS_PATCH
+	{ MODKEY|ShiftMask,     XK_p,         focusbusy,   { 0 } },
+	#endif // PROCSTATS_PATCH
 	{ MODKEY,               XK_1,         move,        { .i = 0 } },
 	{ MODKEY,               XK_2,         move,        { .i = 1 } },
 	{ MODKEY,               XK_3,         move,        { .i = 2 } },
@@ -125,6 +218,12 @@ static const Key keys[] = {
 	{ MODKEY,               XK_0,         move,        { .i = 9 } },
 
 	{ MODKEY,               XK_q,         killclient,  { 0 } },
+	#if BULKOPS_PATCH
+	{ MODKEY|ShiftMask,     XK_q,         closeothers, { 0 } },
+	{ MODKEY|Mod1Mask,      XK_q,         closeright,  { 0 } },
+	{ MODKEY|ShiftMask|Mod1Mask, XK_q,    closeall,    { 0 } },
+	{ MODKEY|ShiftMask,     XK_d,         detachall,   { 0 } },
+	#endif // BULKOPS_PATCH
 
 	{ MODKEY,               XK_u,         focusurgent, { 0 } },
 	{ MODKEY|ShiftMask,     XK_u,         toggle,      { .v = (void*) &urgentswitch } },
@@ -0,0 +1,68 @@
+/* A background tab is marked once the content of its window changes. The
+ * first damage report sets the mark and nothing more is wanted from the tab
+ * until it was selected and left again, so unless the overview patch needs
+ * every change the damage is not even subtracted and the server stays quiet.
+ * A tab that was just left gets activityrate ms to settle before its changes
+ * count again. */
+static Timer activitytimer = { .func = activitytick };
+
+void
+activitydamage(int c)
+{
+	Client *cl = clients[c];
+
+	if (c == sel || cl->actrearm || cl->activity)
+		return;
+	cl->activity = True;
+	drawbar();
+}
+
+void
+activityleave(Client *c)
+{
+	/* no damage, no activity */
+	if (!c->damage)
+		return;
+	c->actrearm = msnow() + activityrate;
+	if (!activitytimer.expires)
+		settimer(&activitytimer, activityrate);
+}
+
+void
+activitytick(void)
+{
+	long long now = msnow(), next = 0;
+	Client *cl;
+	int c;
+
+	for (c = 0; c < nclients; c++) {
+		cl = clients[c];
+		if (!cl->actrearm || !cl->damage || c == sel)
+			continue;
+		if (cl->actrearm <= now) {
+			/* forget what was drawn while the tab was selected */
+			XDamageSubtract(dpy, cl->damage, None, None);
+			cl->actrearm = 0;
+		} else if (!next || cl->actrearm < next) {
+			next = cl->actrearm;
+		}
+	}
+	if (next)
+		settimer(&activitytimer, next - now);
+}
+
+void
+drawactivity(XftColor col[ColLast])
+{
+	int s = MAX(dc.h / 4, 2), x = dc.x + 1;
+
+	#if SEPARATOR_PATCH
+	x += separator;
+	#endif // SEPARATOR_PATCH
+	#if RASTER_PATCH
+	render->fill(x, dc.y + 1, s, s, &col[ColFG]);
+	#else
+	XSetForeground(dpy, dc.gc, col[ColFG].pixel);
+	XFillRectangle(dpy, dc.drawable, dc.gc, x, dc.y + 1, s, s);
+	#endif // RASTER_PATCH
+}
@@ -0,0 +1,4 @@
+static void activitydamage(int c);
+static void activityleave(Client *c);
+static void activitytick(void);
+static void drawactivity(XftColor col[ColLast]);
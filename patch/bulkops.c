@@ -0,0 +1,119 @@
+/* Operations on a range of tabs. The requests for all tabs are queued up and
+ * flushed together, and the tabs are dropped with a single focus and redraw
+ * instead of one full focus cycle per tab. */
+void
+closeall(const Arg *arg)
+{
+	closeclients(0, nclients, -1);
+}
+
+/* Asks the tabs from up to, but not including, to to close, skipping except. */
+void
+closeclients(int from, int to, int except)
+{
+	int c;
+
+	for (c = MAX(from, 0); c < MIN(to, nclients); c++)
+		if (c != except)
+			closeclient(c);
+	XFlush(dpy);
+}
+
+void
+closeothers(const Arg *arg)
+{
+	if (sel > -1)
+		closeclients(0, nclients, sel);
+}
+
+void
+closeright(const Arg *arg)
+{
+	if (sel > -1)
+		closeclients(sel + 1, nclients, -1);
+}
+
+void
+detachall(const Arg *arg)
+{
+	detachclients(0, nclients);
+}
+
+/* Hands the tabs from up to, but not including, to back to the window manager. */
+void
+detachclients(int from, int to)
+{
+	Window w;
+	int c;
+
+	from = MAX(from, 0);
+	to = MIN(to, nclients);
+	for (c = from; c < to; c++) {
+		w = clients[c]->win;
+		XSelectInput(dpy, w, NoEventMask);
+		XUngrabKey(dpy, AnyKey, AnyModifier, w);
+		/* unmap first so that the window manager receives a MapRequest */
+		XUnmapWindow(dpy, w);
+		XReparentWindow(dpy, w, root, 0, 0);
+		XMapWindow(dpy, w);
+	}
+	dropclients(from, to, True);
+}
+
+/* Forgets the tabs from up to, but not including, to like unmanage() does, but
+ * focuses and redraws only once, if at all. */
+void
+dropclients(int from, int to, Bool redraw)
+{
+	int c, n, next;
+
+	from = MAX(from, 0);
+	to = MIN(to, nclients);
+	if ((n = to - from) <= 0)
+		return;
+
+	for (c = from; c < to; c++)
+		freeclient(clients[c]);
+	memmove(&clients[from], &clients[to], sizeof(Client *) * (nclients - to));
+	nclients -= n;
+	#if FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	fallbacktitles(from, nclients);
+	#endif // FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	#if CLIENTLIST_PATCH
+	clientsdirty = titlesdirty = True;
+	#endif // CLIENTLIST_PATCH
+	#if SWITCHER_PATCH
+	switcherupdate(-1);
+	#endif // SWITCHER_PATCH
+
+	if (lastsel >= to)
+		lastsel -= n;
+	else if (lastsel >= from)
+		lastsel = -1;
+
+	if (nclients <= 0) {
+		lastsel = sel = -1;
+		if (closelastclient)
+			running = False;
+		else if (fillagain && running)
+			spawn(NULL);
+		if (!redraw)
+			return;
+		focus(-1);
+	} else if (sel >= from && sel < to) {
+		/* the selected tab is gone */
+		next = lastsel >= 0 ? lastsel : MIN(from, nclients - 1);
+		sel = -1;
+		if (!redraw)
+			return;
+		focus(next);
+		return; /* focus() redraws */
+	} else if (sel >= to) {
+		sel -= n;
+	}
+
+	if (redraw) {
+		drawbar();
+		XSync(dpy, False);
+	}
+}
@@ -0,0 +1,7 @@
+static void closeall(const Arg *arg);
+static void closeclients(int from, int to, int except);
+static void closeothers(const Arg *arg);
+static void closeright(const Arg *arg);
+static void detachall(const Arg *arg);
+static void detachclients(int from, int to);
+static void dropclients(int from, int to, Bool redraw);
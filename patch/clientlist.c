@@ -0,0 +1,71 @@
+/* Publishes the tab list on the tabbed window so that switchers can read it
+ * without walking the window tree:
+ *
+ *    _TABBED_CLIENTS   WINDOW[]       client windows in tab order
+ *    _TABBED_SELECTED  CARDINAL       index of the selected tab
+ *    _TABBED_TITLES    UTF8_STRING    null separated titles in tab order
+ *
+ * Changes are flagged as they happen and written out with the next redraw.
+ */
+static Bool clientsdirty = True, titlesdirty = True;
+static Window *pubclients;
+static int npubclients = -1, pubsel = -2;
+static char *pubtitles;
+static size_t npubtitles = -1;
+
+void
+publishclients(void)
+{
+	int i, n;
+	long psel;
+	size_t len;
+	char *buf;
+
+	if (clientsdirty) {
+		for (n = 0; n < MIN(nclients, npubclients) && pubclients[n] == clients[n]->win; n++);
+		if (n < npubclients)
+			n = 0;
+
+		/* tabs opened at the end only need to be appended */
+		if (n < nclients || nclients != npubclients) {
+			pubclients = erealloc(pubclients, sizeof(Window) * MAX(nclients, 1));
+			for (i = n; i < nclients; i++)
+				pubclients[i] = clients[i]->win;
+			XChangeProperty(dpy, win, wmatom[WMClients], XA_WINDOW, 32,
+			                n ? PropModeAppend : PropModeReplace,
+			                (unsigned char *)&pubclients[n], nclients - n);
+		}
+		npubclients = nclients;
+		clientsdirty = False;
+	}
+
+	if (sel != pubsel) {
+		if (sel < 0) {
+			XDeleteProperty(dpy, win, wmatom[WMSelected]);
+		} else {
+			psel = sel;
+			XChangeProperty(dpy, win, wmatom[WMSelected], XA_CARDINAL, 32,
+			                PropModeReplace, (unsigned char *)&psel, 1);
+		}
+		pubsel = sel;
+	}
+
+	if (titlesdirty) {
+		for (i = 0, len = 0; i < nclients; i++)
+			len += strlen(clients[i]->name) + 1;
+		buf = ecalloc(MAX(len, 1), 1);
+		for (i = 0, len = 0; i < nclients; i++)
+			len += strlen(strcpy(buf + len, clients[i]->name)) + 1;
+
+		if (len != npubtitles || memcmp(buf, pubtitles, len)) {
+			XChangeProperty(dpy, win, wmatom[WMTitles], wmatom[Utf8String], 8,
+			                PropModeReplace, (unsigned char *)buf, len);
+			free(pubtitles);
+			pubtitles = buf;
+			npubtitles = len;
+		} else {
+			free(buf);
+		}
+		titlesdirty = False;
+	}
+}
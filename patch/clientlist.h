@@ -0,0 +1 @@
+static void publishclients(void);
@@ -0,0 +1,522 @@
+/* tabbed -D answers tabbed -a [args...] with a new container. The caller sends
+ * its working directory, environment and arguments, the daemon answers with
+ * the window id or an error and the caller returns. Commands spawned in the
+ * container start in the directory and environment of the caller.
+ *
+ * The containers are served from the daemon process itself. They share the
+ * display connection, the font, the gc and the colours; the tabs, window and
+ * settings of a container are kept in a Container and loaded into the globals
+ * of tabbed while one of its events is handled. Patches that keep state of
+ * their own for the window can not be swapped like that, when one of them is
+ * enabled the daemon forks a tabbed process per container instead and only
+ * the resolved font is shared (see DAEMONSHARED). */
+#if DAEMONSHARED
+static Container *containers, *current;
+static Container defaults; /* the settings before any arguments are parsed */
+static DaemonColor *colors;
+static int ncolors;
+#else
+static FcPattern *daemonfont;
+static char *daemonfontname;
+static int replyfd = -1;
+#endif // DAEMONSHARED
+static int daemonfd = -1;
+
+#if DAEMONSHARED
+/* Called when the container that is loaded stopped running. */
+void
+containerclose(Container *c)
+{
+	Container **cp;
+
+	cleanupwin();
+	for (cp = &containers; *cp != c; cp = &(*cp)->next);
+	*cp = c->next;
+	daemonfree(&c->req);
+	free(c);
+	current = NULL;
+}
+
+/* Saves the globals that belong to a container into c, or loads them from c
+ * if save is False. */
+void
+containercopy(Container *c, Bool save)
+{
+	#define COPY(f, v) if (save) memcpy(&c->f, &(v), sizeof(v)); \
+	                   else memcpy(&(v), &c->f, sizeof(v))
+	COPY(win, win);
+	COPY(drawable, dc.drawable);
+	COPY(norm, dc.norm);
+	COPY(selcol, dc.sel);
+	COPY(urg, dc.urg);
+	COPY(bh, bh);
+	COPY(obh, obh);
+	COPY(wx, wx);
+	COPY(wy, wy);
+	COPY(ww, ww);
+	COPY(wh, wh);
+	#if AUTOHIDE_PATCH || HIDETABS_PATCH
+	COPY(vbh, vbh);
+	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
+	#if HIDETABS_PATCH
+	COPY(barvisibility, barvisibility);
+	#endif // HIDETABS_PATCH
+	#if BASENAME_PATCH
+	COPY(basenametitles, basenametitles);
+	#endif // BASENAME_PATCH
+	COPY(running, running);
+	COPY(nextfocus, nextfocus);
+	COPY(doinitspawn, doinitspawn);
+	COPY(fillagain, fillagain);
+	COPY(closelastclient, closelastclient);
+	COPY(killclientsfirst, killclientsfirst);
+	COPY(clients, clients);
+	COPY(nclients, nclients);
+	COPY(sel, sel);
+	COPY(lastsel, lastsel);
+	COPY(cmd, cmd);
+	COPY(cmd_append_pos, cmd_append_pos);
+	COPY(winid, winid);
+	COPY(wmname, wmname);
+	COPY(geometry, geometry);
+	COPY(normbgcolor, normbgcolor);
+	COPY(normfgcolor, normfgcolor);
+	COPY(selbgcolor, selbgcolor);
+	COPY(selfgcolor, selfgcolor);
+	COPY(urgbgcolor, urgbgcolor);
+	COPY(urgfgcolor, urgfgcolor);
+	COPY(newposition, newposition);
+	COPY(npisrelative, npisrelative);
+	COPY(urgentswitch, urgentswitch);
+	#undef COPY
+}
+
+/* Returns the container of w, its own window or one of its tabs. */
+Container *
+containerfind(Window w)
+{
+	Container *c;
+	int i;
+
+	for (c = containers; c; c = c->next) {
+		if (c->win == w)
+			return c;
+		for (i = 0; i < c->nclients; i++)
+			if (c->clients[i]->win == w)
+				return c;
+	}
+
+	return NULL;
+}
+
+/* Creates the container asked for on fd. */
+void
+containeropen(int fd)
+{
+	char **colstr[] = {
+		&normbgcolor, &normfgcolor, &selbgcolor,
+		&selfgcolor, &urgbgcolor, &urgfgcolor,
+	};
+	char buf[BUFSIZ];
+	Request r = { 0 };
+	Container *c;
+	XftColor col;
+	Bool detach;
+	int i, n;
+
+	if (!daemonrequest(fd, &r)) {
+		daemonfree(&r);
+		close(fd);
+		return;
+	}
+
+	c = ecalloc(1, sizeof(Container));
+	*c = defaults;
+	c->req = r;
+	containercopy(c, False);
+	current = c;
+	/* tabbed -a returns once it has the window id, -d changes nothing */
+	parseargs(r.argc, r.argv, &detach);
+
+	/* a misspelt colour must not take the other containers down */
+	for (i = 0; i < LENGTH(colstr); i++) {
+		if (daemoncolor(*colstr[i], &col))
+			continue;
+		n = snprintf(buf, sizeof(buf), "%s: cannot allocate color '%s'\n",
+		             argv0, *colstr[i]);
+		daemonsend(fd, buf, MIN(n, sizeof(buf) - 1));
+		close(fd);
+		free(cmd);
+		daemonfree(&c->req);
+		free(c);
+		current = NULL;
+		return;
+	}
+
+	setupwin();
+	n = snprintf(buf, sizeof(buf), "0x%lx\n", win);
+	if (!daemonsend(fd, buf, n))
+		fprintf(stderr, "%s: cannot send the window id to the caller\n", argv0);
+	close(fd);
+
+	drawbar();
+	if (doinitspawn == True)
+		spawn(NULL);
+	containercopy(c, True);
+	c->next = containers;
+	containers = c;
+}
+#endif // DAEMONSHARED
+
+/* Returns the next caller of tabbed -a, -1 if there is none. */
+int
+daemonaccept(void)
+{
+	struct timeval tv = { .tv_sec = 1 };
+	int fd;
+
+	if ((fd = accept(daemonfd, NULL, NULL)) < 0) {
+		/* the caller stays pending while descriptors are short, do not
+		 * spin on it */
+		if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+			poll(NULL, 0, 100);
+		return -1;
+	}
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	/* a caller that stops sending or reading must not stall the daemon */
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+	return fd;
+}
+
+#if DAEMONSHARED
+/* Called in spawned commands, they run in the directory and environment of
+ * the caller of tabbed -a. */
+void
+daemonchild(void)
+{
+	if (!current)
+		return;
+	if (chdir(current->req.cwd) < 0)
+		fprintf(stderr, "%s: cannot change directory to '%s'\n", argv0,
+		        current->req.cwd);
+	environ = current->req.env;
+	setenv("XEMBED", winid, 1);
+}
+#endif // DAEMONSHARED
+
+/* Asks the daemon for a container, argv are the arguments after -a. */
+void
+daemonclient(char *argv[])
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	char buf[BUFSIZ], cwd[PATH_MAX];
+	size_t len = 0;
+	ssize_t n;
+	int i, fd;
+	Bool sent;
+
+	daemonpath(addr.sun_path, sizeof(addr.sun_path));
+	if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		return;
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		/* no daemon running, start up as usual */
+		close(fd);
+		return;
+	}
+
+	/* the working directory, the environment up to an empty string, the
+	 * number of arguments and the arguments */
+	if (!getcwd(cwd, sizeof(cwd)))
+		strcpy(cwd, "/");
+	sent = daemonsend(fd, cwd, strlen(cwd) + 1);
+	for (i = 0; sent && environ[i]; i++)
+		sent = daemonsend(fd, environ[i], strlen(environ[i]) + 1);
+	for (i = 0; argv[i]; i++);
+	snprintf(buf, sizeof(buf), "%d", i);
+	sent = sent && daemonsend(fd, "", 1) && daemonsend(fd, buf, strlen(buf) + 1);
+	for (i = 0; sent && argv[i]; i++)
+		sent = daemonsend(fd, argv[i], strlen(argv[i]) + 1);
+	if (!sent) {
+		/* an incomplete request is dropped by the daemon */
+		close(fd);
+		return;
+	}
+	shutdown(fd, SHUT_WR);
+
+	/* the daemon answers with the window id or an error */
+	while (len < sizeof(buf) - 1) {
+		if ((n = read(fd, buf + len, sizeof(buf) - 1 - len)) > 0)
+			len += n;
+		else if (n == 0 || errno != EINTR)
+			break;
+	}
+	close(fd);
+	buf[len] = '\0';
+
+	if (!strncmp(buf, "0x", 2)) {
+		fputs(buf, stdout);
+		exit(EXIT_SUCCESS);
+	}
+	if (!len)
+		die("%s: no answer from the daemon\n", argv0);
+	die("%s", buf);
+}
+
+#if DAEMONSHARED
+/* Returns the colour called name, the containers share the colours they
+ * have in common. */
+Bool
+daemoncolor(const char *name, XftColor *col)
+{
+	int i;
+
+	for (i = 0; i < ncolors; i++) {
+		if (!strcmp(colors[i].name, name)) {
+			*col = colors[i].col;
+			return True;
+		}
+	}
+
+	#if ALPHA_PATCH
+	if (!XftColorAllocName(dpy, visual, cmap, name, col))
+	#else
+	if (!XftColorAllocName(dpy, DefaultVisual(dpy, screen), DefaultColormap(dpy, screen), name, col))
+	#endif // ALPHA_PATCH
+		return False;
+
+	colors = erealloc(colors, (ncolors + 1) * sizeof(*colors));
+	colors[ncolors].name = ecalloc(strlen(name) + 1, 1);
+	strcpy(colors[ncolors].name, name);
+	colors[ncolors++].col = *col;
+
+	return True;
+}
+#endif // DAEMONSHARED
+
+#if DAEMONSHARED
+void
+daemonfree(Request *r)
+{
+	free(r->msg);
+	free(r->env);
+	free(r->argv);
+	memset(r, 0, sizeof(*r));
+}
+#endif // DAEMONSHARED
+
+void
+daemonlisten(void)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	mode_t mask;
+	int n;
+
+	daemonpath(addr.sun_path, sizeof(addr.sun_path));
+	if ((daemonfd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		die("%s: cannot create daemon socket\n", argv0);
+	fcntl(daemonfd, F_SETFD, FD_CLOEXEC);
+
+	/* the socket is created accessible to the user only */
+	unlink(addr.sun_path);
+	mask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+	n = bind(daemonfd, (struct sockaddr *)&addr, sizeof(addr));
+	umask(mask);
+	if (n < 0 || listen(daemonfd, SOMAXCONN) < 0)
+		die("%s: cannot listen on '%s'\n", argv0, addr.sun_path);
+}
+
+void
+daemonpath(char *path, size_t size)
+{
+	const char *dir = getenv("XDG_RUNTIME_DIR"), *d = getenv("DISPLAY");
+	char name[64];
+
+	snprintf(name, sizeof(name), daemonsockpath, d ? d : "");
+	snprintf(path, size, "%s/%s", dir && *dir ? dir : "/tmp", name);
+}
+
+#if !DAEMONSHARED
+/* Sends the window id to the caller of tabbed -a if the daemon forked this
+ * container, returns False otherwise. */
+Bool
+daemonreply(void)
+{
+	char buf[32];
+	int n;
+
+	if (replyfd < 0)
+		return False;
+	n = snprintf(buf, sizeof(buf), "0x%lx\n", win);
+	if (!daemonsend(replyfd, buf, n))
+		fprintf(stderr, "%s: cannot send the window id to the caller\n", argv0);
+	close(replyfd);
+	replyfd = -1;
+
+	return True;
+}
+#endif // DAEMONSHARED
+
+/* Reads the request sent by daemonclient(). */
+Bool
+daemonrequest(int fd, Request *r)
+{
+	char *p, *end, *env;
+	size_t len = 0, size = 0;
+	ssize_t n;
+	int i, nenv, argc;
+
+	for (;;) {
+		if (len == size)
+			r->msg = erealloc(r->msg, size += BUFSIZ);
+		if ((n = read(fd, r->msg + len, size - len)) > 0)
+			len += n;
+		else if (n == 0 || errno != EINTR)
+			break;
+	}
+	if (n < 0 || !len || r->msg[len - 1] != '\0')
+		return False;
+
+	end = r->msg + len;
+	r->cwd = r->msg;
+	env = p = r->cwd + strlen(r->cwd) + 1;
+	for (nenv = 0; p < end && *p; p += strlen(p) + 1, nenv++);
+	if (p + 1 >= end)
+		return False;
+	r->env = ecalloc(nenv + 1, sizeof(char *));
+	for (i = 0, p = env; i < nenv; p += strlen(p) + 1)
+		r->env[i++] = p;
+	if ((argc = atoi(++p)) < 0 || argc > (int)len)
+		return False;
+	p += strlen(p) + 1;
+
+	r->argv = ecalloc(argc + 2, sizeof(char *));
+	r->argv[0] = argv0;
+	for (r->argc = 1; p < end && r->argc <= argc; p += strlen(p) + 1)
+		r->argv[r->argc++] = p;
+
+	/* anything short of all arguments is an interrupted caller */
+	return r->argc == argc + 1 && p == end;
+}
+
+#if DAEMONSHARED
+void
+daemonrun(void)
+{
+	struct pollfd pfd[] = {
+		{ .fd = ConnectionNumber(dpy), .events = POLLIN },
+		{ .fd = daemonfd, .events = POLLIN },
+	};
+	Container *c;
+	XEvent ev;
+	int fd;
+
+	for (;;) {
+		while (XPending(dpy)) {
+			XNextEvent(dpy, &ev);
+			if (!handler[ev.type] || !(c = containerfind(ev.xany.window)))
+				continue;
+			containercopy(c, False);
+			current = c;
+			(handler[ev.type])(&ev); /* call handler */
+			if (running)
+				containercopy(c, True);
+			else
+				containerclose(c);
+		}
+		if (poll(pfd, LENGTH(pfd), -1) < 0 && errno != EINTR)
+			die("%s: poll failed\n", argv0);
+		if (pfd[1].revents & POLLIN)
+			while ((fd = daemonaccept()) >= 0)
+				containeropen(fd);
+	}
+}
+#endif // DAEMONSHARED
+
+/* Sends all of buf, False if the other end went away. */
+Bool
+daemonsend(int fd, const char *buf, size_t len)
+{
+	ssize_t n;
+
+	while (len) {
+		if ((n = send(fd, buf, len, MSG_NOSIGNAL)) < 0) {
+			if (errno == EINTR)
+				continue;
+			return False;
+		}
+		buf += n;
+		len -= n;
+	}
+
+	return True;
+}
+
+void
+daemonserve(int *argc, char **argv[])
+{
+	#if DAEMONSHARED
+	if (!setlocale(LC_CTYPE, "") || !XSupportsLocale())
+		fprintf(stderr, "%s: no locale support\n", argv0);
+	if (!(dpy = XOpenDisplay(NULL)))
+		die("%s: cannot open display\n", argv0);
+	#if XRESOURCES_PATCH
+	config_init();
+	#endif // XRESOURCES_PATCH
+	setup();
+	containercopy(&defaults, True);
+
+	daemonlisten();
+	fcntl(daemonfd, F_SETFL, fcntl(daemonfd, F_GETFL) | O_NONBLOCK);
+	daemonrun();
+	#else
+	struct sigaction sa;
+	FcResult result;
+	FcPattern *pat;
+	Request r = { 0 };
+	int fd;
+
+	if (!setlocale(LC_CTYPE, "") || !XSupportsLocale())
+		fprintf(stderr, "%s: no locale support\n", argv0);
+	if (!(dpy = XOpenDisplay(NULL)))
+		die("%s: cannot open display\n", argv0);
+	screen = DefaultScreen(dpy);
+
+	/* do the expensive font matching once, containers open the result */
+	if ((pat = FcNameParse((FcChar8 *)font))) {
+		daemonfont = XftFontMatch(dpy, screen, pat, &result);
+		daemonfontname = font;
+		FcPatternDestroy(pat);
+	}
+	XCloseDisplay(dpy);
+	dpy = NULL;
+
+	daemonlisten();
+
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_NOCLDSTOP | SA_NOCLDWAIT | SA_RESTART;
+	sa.sa_handler = SIG_IGN;
+	sigaction(SIGCHLD, &sa, NULL);
+
+	for (;;) {
+		if ((fd = daemonaccept()) < 0)
+			continue;
+		if (fork() == 0)
+			break;
+		close(fd);
+	}
+
+	/* container: take over the directory and environment of the caller, the
+	 * window id goes back through fd in daemonreply() */
+	close(daemonfd);
+	if (!daemonrequest(fd, &r))
+		exit(EXIT_FAILURE);
+	if (chdir(r.cwd) < 0)
+		fprintf(stderr, "%s: cannot change directory to '%s'\n", argv0, r.cwd);
+	environ = r.env;
+	replyfd = fd;
+	*argc = r.argc;
+	*argv = r.argv;
+	#endif // DAEMONSHARED
+}
@@ -0,0 +1,75 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+typedef struct {
+	char *msg;   /* the request as sent, the strings below point into it */
+	char *cwd;
+	char **env;
+	char **argv; /* argv0 followed by the arguments of tabbed -a */
+	int argc;
+} Request;
+
+#if DAEMONSHARED
+/* The state of a container while another one is being served. */
+typedef struct Container Container;
+struct Container {
+	Request req;
+	Window win;
+	Drawable drawable;
+	XftColor norm[ColLast], selcol[ColLast], urg[ColLast];
+	int bh, obh, wx, wy, ww, wh;
+	#if AUTOHIDE_PATCH || HIDETABS_PATCH
+	int vbh;
+	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
+	#if HIDETABS_PATCH
+	Bool barvisibility;
+	#endif // HIDETABS_PATCH
+	#if BASENAME_PATCH
+	Bool basenametitles;
+	#endif // BASENAME_PATCH
+	Bool running, nextfocus, doinitspawn, fillagain, closelastclient, killclientsfirst;
+	Client **clients;
+	int nclients, sel, lastsel;
+	char **cmd;
+	int cmd_append_pos;
+	char winid[64];
+	char *wmname;
+	const char *geometry;
+	char *normbgcolor, *normfgcolor, *selbgcolor, *selfgcolor, *urgbgcolor, *urgfgcolor;
+	int newposition, npisrelative, urgentswitch;
+	Container *next;
+};
+
+typedef struct {
+	char *name;
+	XftColor col;
+} DaemonColor;
+#endif // DAEMONSHARED
+
+extern char **environ;
+
+static int daemonaccept(void);
+static void daemonclient(char *argv[]);
+static void daemonlisten(void);
+static void daemonpath(char *path, size_t size);
+static Bool daemonrequest(int fd, Request *r);
+static Bool daemonsend(int fd, const char *buf, size_t len);
+static void daemonserve(int *argc, char **argv[]);
+#if DAEMONSHARED
+static void containerclose(Container *c);
+static void containercopy(Container *c, Bool save);
+static Container *containerfind(Window w);
+static void containeropen(int fd);
+static void daemonchild(void);
+static Bool daemoncolor(const char *name, XftColor *col);
+static void daemonfree(Request *r);
+static void daemonrun(void);
+#else
+static Bool daemonreply(void);
+#endif // DAEMONSHARED
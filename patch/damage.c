@@ -0,0 +1,82 @@
+/* Client windows are redirected with Composite, so that the content of tabs
+ * hidden behind the selected one is still drawn, and watched with one Damage
+ * object each, shared by the patches that follow content changes. */
+static Bool damageok;
+static int damageevent, damageop, compositeop;
+
+void
+damageinit(void)
+{
+	int ev, err, major, minor;
+
+	if (!XQueryExtension(dpy, COMPOSITE_NAME, &compositeop, &ev, &err)
+	    || !XCompositeQueryVersion(dpy, &major, &minor)
+	    || (major == 0 && minor < 2) /* for XCompositeNameWindowPixmap() */
+	    || !XQueryExtension(dpy, DAMAGE_NAME, &damageop, &ev, &err)
+	    || !XDamageQueryExtension(dpy, &damageevent, &err))
+		return;
+	damageok = True;
+}
+
+/* Requests on a client window race with the client destroying it, which also
+ * frees its damage object. */
+Bool
+damageerror(XErrorEvent *ee)
+{
+	return damageok && (ee->request_code == compositeop ||
+	                    ee->request_code == damageop);
+}
+
+void
+damagemanage(Client *c)
+{
+	if (!damageok)
+		return;
+	XCompositeRedirectWindow(dpy, c->win, CompositeRedirectAutomatic);
+	c->damage = XDamageCreate(dpy, c->win, XDamageReportNonEmpty);
+	#if ACTIVITY_PATCH
+	activityleave(c);
+	#endif // ACTIVITY_PATCH
+	#if OVERVIEW_PATCH
+	c->thumbdirty = True;
+	thumbschedule(c);
+	#endif // OVERVIEW_PATCH
+}
+
+void
+damagenotify(const XEvent *e)
+{
+	const XDamageNotifyEvent *ev = (const XDamageNotifyEvent *)e;
+	int c;
+
+	if ((c = getclient(ev->drawable)) < 0)
+		return;
+	#if OVERVIEW_PATCH
+	/* rearm the report, the thumbnail is rendered from the whole window */
+	XDamageSubtract(dpy, ev->damage, None, None);
+	clients[c]->thumbdirty = True;
+	thumbschedule(clients[c]);
+	#endif // OVERVIEW_PATCH
+	#if ACTIVITY_PATCH
+	activitydamage(c);
+	#endif // ACTIVITY_PATCH
+}
+
+void
+damageunmanage(Client *c)
+{
+	#if OVERVIEW_PATCH
+	thumbfree(c);
+	#endif // OVERVIEW_PATCH
+	if (!c->damage)
+		return;
+	XDamageDestroy(dpy, c->damage);
+	XCompositeUnredirectWindow(dpy, c->win, CompositeRedirectAutomatic);
+	c->damage = None;
+}
+
+Bool
+isdamageevent(const XEvent *ev)
+{
+	return damageok && ev->type == damageevent + XDamageNotify;
+}
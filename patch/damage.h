@@ -0,0 +1,6 @@
+static Bool damageerror(XErrorEvent *ee);
+static void damageinit(void);
+static void damagemanage(Client *c);
+static void damagenotify(const XEvent *e);
+static void damageunmanage(Client *c);
+static Bool isdamageevent(const XEvent *ev);
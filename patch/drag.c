@@ -2,33 +2,50 @@ void
 motionnotify(const XEvent *e)
 {
 	const XMotionEvent *ev = &e->xmotion;
-	int i, fc;
+	int i;
+	#if !LAYOUTCACHE_PATCH && !SIDEBAR_PATCH
+	int fc;
+	#endif // LAYOUTCACHE_PATCH | SIDEBAR_PATCH
 	Arg arg;
 
+	#if !SIDEBAR_PATCH
 	if (ev->y < 0 || ev->y > bh)
 		return;
+	#endif // SIDEBAR_PATCH
 
 	if (! (ev->state & Button1Mask)) {
 		return;
 	}
 
+	#if POINTERCOMPRESS_PATCH
+	dragmotion(ev->x, ev->y);
+	return;
+	#endif // POINTERCOMPRESS_PATCH
+
+	#if SIDEBAR_PATCH
+	if ((i = sidebarhit(ev->x, ev->y)) < 0)
+		return;
+	#elif LAYOUTCACHE_PATCH
+	if ((i = layouthit(ev->x)) < 0)
+		return;
+	#else
 	if (((fc = getfirsttab()) > 0 && ev->x < TEXTW(before)) || ev->x < 0)
 		return;
 
+	for (i = fc; i < nclients && clients[i]->tabx <= ev->x; i++);
+	if (i >= nclients)
+		return;
+	#endif // LAYOUTCACHE_PATCH
+
 	if (sel < 0)
 		return;
 
-	for (i = fc; i < nclients; i++) {
-		if (clients[i]->tabx > ev->x) {
-			if (i == sel+1) {
-				arg.i = 1;
-				movetab(&arg);
-			}
-			if (i == sel-1) {
-				arg.i = -1;
-				movetab(&arg);
-			}
-			break;
-		}
+	if (i == sel+1) {
+		arg.i = 1;
+		movetab(&arg);
+	}
+	if (i == sel-1) {
+		arg.i = -1;
+		movetab(&arg);
 	}
 }
\ No newline at end of file
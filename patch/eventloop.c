@@ -0,0 +1,147 @@
+/* File descriptors and timers that are served alongside the X connection. */
+typedef struct {
+	int fd;
+	short events;
+	void (*func)(int fd, short revents);
+} Watch;
+
+static Watch *watches;
+static int nwatches;
+static Timer *timers;
+
+#if FDWATCH
+void
+addwatch(int fd, short events, void (*func)(int fd, short revents))
+{
+	watches = erealloc(watches, sizeof(Watch) * (nwatches + 1));
+	watches[nwatches].fd = fd;
+	watches[nwatches].events = events;
+	watches[nwatches].func = func;
+	nwatches++;
+}
+
+void
+delwatch(int fd)
+{
+	int i;
+
+	for (i = 0; i < nwatches; i++) {
+		if (watches[i].fd == fd) {
+			memmove(&watches[i], &watches[i + 1],
+			        sizeof(Watch) * (nwatches - i - 1));
+			nwatches--;
+			return;
+		}
+	}
+}
+#endif // FDWATCH
+#if IPC_PATCH
+
+void
+setwatch(int fd, short events)
+{
+	int i;
+
+	for (i = 0; i < nwatches; i++)
+		if (watches[i].fd == fd)
+			watches[i].events = events;
+}
+#endif // IPC_PATCH
+
+long long
+msnow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+#if TIMERS
+void
+settimer(Timer *t, long ms)
+{
+	Timer **tp;
+
+	stoptimer(t);
+	t->expires = msnow() + MAX(ms, 0);
+	if (!t->expires)
+		t->expires = 1;
+
+	/* keep the list sorted by expiry so only the head needs checking */
+	for (tp = &timers; *tp && (*tp)->expires <= t->expires; tp = &(*tp)->next);
+	t->next = *tp;
+	*tp = t;
+}
+#endif // TIMERS
+
+void
+stoptimer(Timer *t)
+{
+	Timer **tp;
+
+	if (!t->expires)
+		return;
+	for (tp = &timers; *tp; tp = &(*tp)->next) {
+		if (*tp == t) {
+			*tp = t->next;
+			break;
+		}
+	}
+	t->expires = 0;
+	t->next = NULL;
+}
+
+/* Blocks until the X connection or any watched descriptor becomes readable or
+ * the earliest timer expires, then dispatches the watches and timers. X events
+ * are left for the caller to read. */
+void
+waitevents(void)
+{
+	static struct pollfd *pfd;
+	static int npfd;
+	Timer *t;
+	long long now;
+	int i, j, n, timeout = -1;
+
+	XFlush(dpy);
+	if (XPending(dpy))
+		return;
+
+	if (npfd < nwatches + 1) {
+		npfd = nwatches + 1;
+		pfd = erealloc(pfd, sizeof(struct pollfd) * npfd);
+	}
+	pfd[0].fd = ConnectionNumber(dpy);
+	pfd[0].events = POLLIN;
+	for (i = 0; i < nwatches; i++) {
+		pfd[i + 1].fd = watches[i].fd;
+		pfd[i + 1].events = watches[i].events;
+		pfd[i + 1].revents = 0;
+	}
+	n = nwatches;
+
+	if (timers)
+		timeout = MAX(0, timers->expires - msnow());
+
+	if (poll(pfd, n + 1, timeout) < 0 && errno != EINTR)
+		die("%s: poll failed\n", argv0);
+
+	/* callbacks may add or remove watches, so look each one up again */
+	for (i = 1; i <= n; i++) {
+		if (!pfd[i].revents)
+			continue;
+		for (j = 0; j < nwatches; j++) {
+			if (watches[j].fd == pfd[i].fd) {
+				watches[j].func(pfd[i].fd, pfd[i].revents);
+				break;
+			}
+		}
+	}
+
+	now = msnow();
+	while ((t = timers) && t->expires <= now) {
+		stoptimer(t);
+		t->func();
+	}
+}
@@ -0,0 +1,24 @@
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+
+typedef struct Timer Timer;
+struct Timer {
+	long long expires; /* CLOCK_MONOTONIC milliseconds, 0 when not armed */
+	void (*func)(void);
+	Timer *next;
+};
+
+#if FDWATCH
+static void addwatch(int fd, short events, void (*func)(int fd, short revents));
+static void delwatch(int fd);
+#endif // FDWATCH
+#if IPC_PATCH
+static void setwatch(int fd, short events);
+#endif // IPC_PATCH
+static long long msnow(void);
+#if TIMERS
+static void settimer(Timer *t, long ms);
+#endif // TIMERS
+static void stoptimer(Timer *t);
+static void waitevents(void);
@@ -0,0 +1,195 @@
+/* Events are read off the connection into one queue per class and handled
+ * input first, then structural changes, then cosmetic updates. Before every
+ * cosmetic event the connection is read again, so a key press that arrives
+ * during a storm of title changes overtakes them. Property changes of the
+ * same window and atom and exposures of the bar are merged while queued. */
+typedef struct {
+	XEvent ev;
+	long long queued; /* microseconds, when it was read off the connection */
+} QueuedEvent;
+
+typedef struct {
+	QueuedEvent *ev;
+	int head, n, size;
+} EventQueue;
+
+static EventQueue evqueues[EvLast];
+/* time from reading a key or button press to having handled it, bucket i
+ * counts latencies in [2^i, 2^(i+1)) microseconds */
+static unsigned long latencyhist[LATENCYBUCKETS];
+static Bool showlatency;
+
+static long long
+usnow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static int
+eventclass(const XEvent *ev)
+{
+	if (!eventpriority)
+		return EvStructure; /* arrival order */
+
+	switch (ev->type) {
+	case KeyPress:
+	case KeyRelease:
+	case ButtonPress:
+	case ButtonRelease:
+	case MotionNotify:
+		return EvInput;
+	case PropertyNotify:
+	case Expose:
+		return EvCosmetic;
+	default:
+		#if DAMAGEWATCH
+		if (isdamageevent(ev))
+			return EvCosmetic;
+		#endif // DAMAGEWATCH
+		return EvStructure;
+	}
+}
+
+void
+latencyreport(void)
+{
+	unsigned long total = 0;
+	int i;
+
+	if (!showlatency)
+		return;
+	for (i = 0; i < LATENCYBUCKETS; i++)
+		total += latencyhist[i];
+	if (!total)
+		return;
+	for (i = 0; i < LATENCYBUCKETS; i++)
+		if (latencyhist[i])
+			fprintf(stderr, "%s: latency >= %7lu us %8lu %5.1f%%\n", argv0,
+			        i ? 1UL << i : 0, latencyhist[i],
+			        100.0 * latencyhist[i] / total);
+	showlatency = False;
+}
+
+void
+queueevent(const XEvent *ev)
+{
+	EventQueue *q = &evqueues[eventclass(ev)];
+	QueuedEvent *qe;
+	int i;
+
+	if (q == &evqueues[EvCosmetic]) {
+		for (i = q->head; i < q->head + q->n; i++) {
+			qe = &q->ev[i];
+			if (qe->ev.type != ev->type)
+				continue;
+			if (ev->type == PropertyNotify
+			    && qe->ev.xproperty.window == ev->xproperty.window
+			    && qe->ev.xproperty.atom == ev->xproperty.atom) {
+				/* only the latest state matters */
+				qe->ev = *ev;
+				return;
+			}
+			if (ev->type == Expose && ev->xexpose.window == win
+			    && qe->ev.xexpose.window == win)
+				return; /* the whole bar is redrawn anyway */
+			#if DAMAGEWATCH
+			if (isdamageevent(ev) && ((XDamageNotifyEvent *)&qe->ev)->drawable
+			    == ((XDamageNotifyEvent *)ev)->drawable)
+				return; /* one report per window is enough */
+			#endif // DAMAGEWATCH
+		}
+	}
+
+	if (q->head + q->n == q->size) {
+		if (q->head) {
+			memmove(q->ev, &q->ev[q->head], sizeof(QueuedEvent) * q->n);
+			q->head = 0;
+		} else {
+			q->size = q->size ? q->size * 2 : 64;
+			q->ev = erealloc(q->ev, sizeof(QueuedEvent) * q->size);
+		}
+	}
+	qe = &q->ev[q->head + q->n++];
+	qe->ev = *ev;
+	qe->queued = usnow();
+	if (ev->type == Expose && ev->xexpose.window == win)
+		qe->ev.xexpose.count = 0;
+}
+
+void
+readevents(void)
+{
+	XEvent ev;
+
+	/* does not flush, so it only costs a read on the connection */
+	while (XEventsQueued(dpy, QueuedAfterReading)) {
+		XNextEvent(dpy, &ev);
+		queueevent(&ev);
+	}
+}
+
+void
+schedevents(void)
+{
+	QueuedEvent qe;
+	EventQueue *q;
+	Bool held = False;
+	long long us;
+	int cls, i;
+
+	while (running) {
+		for (cls = 0; cls < EvLast && !evqueues[cls].n; cls++);
+		if (cls == EvLast || cls == EvCosmetic) {
+			readevents();
+			for (cls = 0; cls < EvLast && !evqueues[cls].n; cls++);
+			if (cls == EvLast)
+				break;
+		}
+
+		/* cosmetic updates only redraw once the run of them ends */
+		if (cls == EvCosmetic && !held) {
+			drawhold++;
+			held = True;
+		} else if (cls != EvCosmetic && held) {
+			held = False;
+			if (--drawhold == 0 && drawpending) {
+				drawpending = False;
+				drawbar();
+			}
+		}
+
+		q = &evqueues[cls];
+		qe = q->ev[q->head];
+		q->head = --q->n ? q->head + 1 : 0;
+
+		#if DAMAGEWATCH
+		if (isdamageevent(&qe.ev))
+			damagenotify(&qe.ev);
+		else
+		#endif // DAMAGEWATCH
+		#if FRAMEPACE_PATCH
+		if (israndrevent(&qe.ev))
+			randrnotify(&qe.ev);
+		else
+		#endif // FRAMEPACE_PATCH
+		if (handler[qe.ev.type])
+			(handler[qe.ev.type])(&qe.ev); /* call handler */
+		#if POINTERCOMPRESS_PATCH
+		pointersettle();
+		#endif // POINTERCOMPRESS_PATCH
+
+		if (qe.ev.type == KeyPress || qe.ev.type == ButtonPress) {
+			us = usnow() - qe.queued;
+			for (i = 0; i < LATENCYBUCKETS - 1 && us >> (i + 1); i++);
+			latencyhist[i]++;
+		}
+	}
+
+	if (held && --drawhold == 0 && drawpending) {
+		drawpending = False;
+		drawbar();
+	}
+}
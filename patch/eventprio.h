@@ -0,0 +1,8 @@
+enum { EvInput, EvStructure, EvCosmetic, EvLast }; /* event classes */
+
+#define LATENCYBUCKETS 20
+
+static void latencyreport(void);
+static void queueevent(const XEvent *ev);
+static void readevents(void);
+static void schedevents(void);
@@ -0,0 +1,153 @@
+/* The font pattern that fontconfig resolves for the font string is kept in
+ * $XDG_CACHE_HOME/tabbed/fonts, one "stamp<TAB>font<TAB>pattern" line per font.
+ * On a hit the pattern is opened directly, which skips loading the fontconfig
+ * configuration and font caches as well as the match itself. The stamp is the
+ * newest mtime of the fontconfig configuration, so entries are dropped when
+ * it changes; a pattern whose font file is gone simply fails to open. */
+static struct {
+	const char *phase;
+	struct timespec ts;
+} startupmarks[16];
+static int nstartupmarks;
+static Bool showstartup = False;
+
+XftFont *
+fontcacheopen(const char *fontstr)
+{
+	char path[PATH_MAX], *line = NULL, *name, *pat;
+	size_t size = 0, len = strlen(fontstr);
+	long long stamp = fontconfigstamp();
+	XftFont *xfont = NULL;
+	FcPattern *p;
+	FILE *f;
+
+	fontcachepath(path, sizeof(path), False);
+	if (!(f = fopen(path, "r")))
+		return NULL;
+	while (getline(&line, &size, f) > 0) {
+		if (strtoll(line, &name, 10) != stamp || *name++ != '\t'
+		    || strncmp(name, fontstr, len) || name[len] != '\t')
+			continue;
+		pat = name + len + 1;
+		pat[strcspn(pat, "\n")] = '\0';
+		if ((p = FcNameParse((FcChar8 *)pat))
+		    && !(xfont = XftFontOpenPattern(dpy, p)))
+			FcPatternDestroy(p);
+		break;
+	}
+	free(line);
+	fclose(f);
+
+	return xfont;
+}
+
+void
+fontcachepath(char *path, size_t size, Bool mkdirs)
+{
+	const char *xdg = getenv("XDG_CACHE_HOME"), *home = getenv("HOME");
+
+	if (xdg && *xdg)
+		snprintf(path, size, "%s/tabbed", xdg);
+	else
+		snprintf(path, size, "%s/.cache/tabbed", home ? home : "");
+	if (mkdirs) {
+		*strrchr(path, '/') = '\0';
+		mkdir(path, 0700);
+		path[strlen(path)] = '/';
+		mkdir(path, 0700);
+	}
+	strncat(path, "/fonts", size - strlen(path) - 1);
+}
+
+void
+fontcachesave(const char *fontstr, XftFont *xfont)
+{
+	char path[PATH_MAX], tmp[PATH_MAX + 16], *line = NULL, *name;
+	long long stamp = fontconfigstamp();
+	size_t size = 0, len = strlen(fontstr);
+	FcChar8 *pat;
+	FILE *f, *out;
+
+	if (fontstr[strcspn(fontstr, "\t\n")]
+	    || !(pat = FcNameUnparse(xfont->pattern)))
+		return;
+
+	fontcachepath(path, sizeof(path), True);
+	snprintf(tmp, sizeof(tmp), "%s.%d", path, getpid());
+	if (!(out = fopen(tmp, "w"))) {
+		free(pat);
+		return;
+	}
+	/* keep the still valid entries of other fonts */
+	if ((f = fopen(path, "r"))) {
+		while (getline(&line, &size, f) > 0) {
+			if (strtoll(line, &name, 10) != stamp || *name++ != '\t'
+			    || (!strncmp(name, fontstr, len) && name[len] == '\t'))
+				continue;
+			fputs(line, out);
+		}
+		free(line);
+		fclose(f);
+	}
+	fprintf(out, "%lld\t%s\t%s\n", stamp, fontstr, (char *)pat);
+	free(pat);
+
+	if (fclose(out) || rename(tmp, path))
+		unlink(tmp);
+}
+
+long long
+fontconfigstamp(void)
+{
+	const char *files[] = {
+		getenv("FONTCONFIG_FILE"), "/etc/fonts/fonts.conf", "/etc/fonts/conf.d",
+		"fontconfig/fonts.conf", "fontconfig/conf.d",
+	};
+	const char *xdg = getenv("XDG_CONFIG_HOME"), *home = getenv("HOME");
+	char path[PATH_MAX];
+	long long stamp = 0;
+	struct stat st;
+	int i;
+
+	for (i = 0; i < LENGTH(files); i++) {
+		if (!files[i])
+			continue;
+		if (files[i][0] == '/')
+			snprintf(path, sizeof(path), "%s", files[i]);
+		else if (xdg && *xdg)
+			snprintf(path, sizeof(path), "%s/%s", xdg, files[i]);
+		else
+			snprintf(path, sizeof(path), "%s/.config/%s", home ? home : "", files[i]);
+		if (!stat(path, &st))
+			stamp = MAX(stamp, (long long)st.st_mtime);
+	}
+
+	return stamp;
+}
+
+void
+startupmark(const char *phase)
+{
+	if (nstartupmarks == LENGTH(startupmarks))
+		return;
+	startupmarks[nstartupmarks].phase = phase;
+	clock_gettime(CLOCK_MONOTONIC, &startupmarks[nstartupmarks++].ts);
+}
+
+void
+startupreport(void)
+{
+	double ms, total = 0;
+	int i;
+
+	if (!showstartup)
+		return;
+	for (i = 1; i < nstartupmarks; i++) {
+		ms = (startupmarks[i].ts.tv_sec - startupmarks[i - 1].ts.tv_sec) * 1e3
+		   + (startupmarks[i].ts.tv_nsec - startupmarks[i - 1].ts.tv_nsec) / 1e6;
+		total += ms;
+		fprintf(stderr, "%s: %-12s %8.3f ms\n", argv0, startupmarks[i].phase, ms);
+	}
+	fprintf(stderr, "%s: %-12s %8.3f ms\n", argv0, "total", total);
+	showstartup = False;
+}
@@ -0,0 +1,11 @@
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <time.h>
+
+static XftFont *fontcacheopen(const char *fontstr);
+static void fontcachepath(char *path, size_t size, Bool mkdirs);
+static void fontcachesave(const char *fontstr, XftFont *font);
+static long long fontconfigstamp(void);
+static void startupmark(const char *phase);
+static void startupreport(void);
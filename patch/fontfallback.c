@@ -0,0 +1,339 @@
+/* Characters the font lacks are drawn with the fonts listed in fallbackfonts
+ * (config.h) and then with whatever font fontconfig matches for them. Which
+ * font draws a codepoint is decided once and kept in a hash table until the
+ * font changes. Every tab keeps its title split into runs of one font along
+ * with their widths, built when the title changes, so redrawing the bar does
+ * no font matching and no per character coverage checks. */
+static XftFont *fallbacks[FALLBACKMAX];
+static int nfallbacks, nconfigured;
+static FcPattern *fallbackpat; /* the font as requested, matched against */
+static CharFont *charfonts;
+static int ncharfonts, charfontcap;
+static TextRuns scratch = { .len = -1 }; /* runs of text that is not a title */
+
+/* Colour fonts make Xft fail with BadLength and the raster backend only draws
+ * coverage masks, so they are not used. */
+Bool
+addfallback(XftFont *f)
+{
+	FcBool color;
+
+	if (!f)
+		return False;
+	if (nfallbacks == FALLBACKMAX
+	    || (FcPatternGetBool(f->pattern, FC_COLOR, 0, &color) == FcResultMatch && color)) {
+		XftFontClose(dpy, f);
+		return False;
+	}
+	fallbacks[nfallbacks++] = f;
+	return True;
+}
+
+int
+charfont(FcChar32 ucs)
+{
+	CharFont *e, *old;
+	int i, oldcap;
+
+	if (ncharfonts * 2 >= charfontcap) {
+		old = charfonts;
+		oldcap = charfontcap;
+		charfontcap = charfontcap ? charfontcap * 2 : 256;
+		charfonts = ecalloc(charfontcap, sizeof(*charfonts));
+		ncharfonts = 0;
+		for (i = 0; i < oldcap; i++) {
+			if (!old[i].used)
+				continue;
+			for (e = &charfonts[old[i].ucs & (charfontcap - 1)]; e->used;
+			     e = e == &charfonts[charfontcap - 1] ? charfonts : e + 1);
+			*e = old[i];
+			ncharfonts++;
+		}
+		free(old);
+	}
+
+	for (e = &charfonts[ucs & (charfontcap - 1)]; e->used;
+	     e = e == &charfonts[charfontcap - 1] ? charfonts : e + 1)
+		if (e->ucs == ucs)
+			return e->font;
+
+	e->used = True;
+	e->ucs = ucs;
+	e->font = findfont(ucs);
+	ncharfonts++;
+
+	return e->font;
+}
+
+/* Draws the first len bytes of the runs. When trim is set the text was
+ * shortened and trim takes the place of its last bytes. */
+void
+drawruns(TextRuns *r, int x, int y, const XftColor *col, int len, const char *trim)
+{
+	TextRun *run;
+	int i, n, keep = len, tlen = 0;
+
+	if (trim) {
+		tlen = MIN((int)strlen(trim), len);
+		/* never keep half a character in front of the marker */
+		for (keep = len - tlen; keep > 0 && (r->text[keep] & 0xc0) == 0x80; keep--);
+	}
+
+	for (i = 0; i < r->nrun && r->run[i].off < keep; i++) {
+		run = &r->run[i];
+		n = MIN(run->len, keep - run->off);
+		fonttext(runfont(run->font), x, y, col, r->text + run->off, n);
+		x += n == run->len ? run->w :
+		     fontwidth(runfont(run->font), r->text + run->off, n);
+	}
+	if (tlen)
+		fonttext(dc.font.xfont, x, y, col, trim + strlen(trim) - tlen, tlen);
+}
+
+void
+fallbackfree(TextRuns *r)
+{
+	free(r->text);
+	free(r->run);
+	memset(r, 0, sizeof(*r));
+}
+
+/* Called when the font changes. */
+void
+fallbackreset(const char *fontstr)
+{
+	int c;
+
+	while (nfallbacks)
+		XftFontClose(dpy, fallbacks[--nfallbacks]);
+	nconfigured = 0;
+	free(charfonts);
+	charfonts = NULL;
+	ncharfonts = charfontcap = 0;
+
+	if (fallbackpat)
+		FcPatternDestroy(fallbackpat);
+	fallbackpat = FcNameParse((FcChar8 *)fontstr);
+
+	/* the runs refer to the closed fonts */
+	for (c = 0; c < nclients; c++)
+		clients[c]->runs.len = -1;
+	scratch.len = -1;
+}
+
+/* Called when the title of tab c changed, splits it the way drawbar() will
+ * draw it. */
+void
+fallbacktitle(int c)
+{
+	const char *t = clients[c]->name;
+	#if CLIENTNUMBER_PATCH
+	char buf[312];
+	#endif // CLIENTNUMBER_PATCH
+
+	#if BASENAME_PATCH
+	if (basenametitles)
+		t = clients[c]->basename;
+	#endif // BASENAME_PATCH
+	#if CLIENTNUMBER_PATCH
+	snprintf(buf, sizeof(buf), "%d: %s", c + 1, t);
+	t = buf;
+	#endif // CLIENTNUMBER_PATCH
+	clients[c]->runs.len = -1;
+	getruns(&clients[c]->runs, t, MIN(strlen(t), 256));
+}
+
+/* Called when the font changed or the tabs from up to, but not including, to
+ * changed their number, so that drawing finds their runs ready. */
+void
+fallbacktitles(int from, int to)
+{
+	int c;
+
+	for (c = MAX(from, 0); c < MIN(to, nclients); c++)
+		fallbacktitle(c);
+}
+
+/* Returns the font that draws ucs, 0 if none does and the font draws its
+ * missing glyph. */
+int
+findfont(FcChar32 ucs)
+{
+	int i;
+
+	if (XftCharExists(dpy, dc.font.xfont, ucs))
+		return 0;
+	for (i = 0; i < nfallbacks; i++)
+		if (XftCharExists(dpy, fallbacks[i], ucs))
+			return i + 1;
+
+	/* the configured fonts are only opened once they are needed */
+	while (nconfigured < LENGTH(fallbackfonts)) {
+		if (addfallback(XftFontOpenName(dpy, screen, fallbackfonts[nconfigured++]))
+		    && XftCharExists(dpy, fallbacks[nfallbacks - 1], ucs))
+			return nfallbacks;
+	}
+
+	return addfallback(matchfont(ucs)) ? nfallbacks : 0;
+}
+
+void
+fonttext(XftFont *f, int x, int y, const XftColor *col, const char *text, int len)
+{
+	#if RASTER_PATCH
+	XftFont *font = dc.font.xfont;
+
+	/* the backends draw with the font of the draw context */
+	dc.font.xfont = f;
+	render->text(x, y, col, text, len);
+	dc.font.xfont = font;
+	#else
+	XftDraw *d;
+
+	#if ALPHA_PATCH
+	d = XftDrawCreate(dpy, dc.drawable, visual, cmap);
+	#else
+	d = XftDrawCreate(dpy, dc.drawable, DefaultVisual(dpy, screen), DefaultColormap(dpy, screen));
+	#endif // ALPHA_PATCH
+	XftDrawStringUtf8(d, col, f, x, y, (XftChar8 *) text, len);
+	XftDrawDestroy(d);
+	#endif // RASTER_PATCH
+}
+
+int
+fontwidth(XftFont *f, const char *text, int len)
+{
+	#if RASTER_PATCH
+	XftFont *font = dc.font.xfont;
+	int w;
+
+	dc.font.xfont = f;
+	w = render->textw(text, len);
+	dc.font.xfont = font;
+
+	return w;
+	#else
+	XGlyphInfo ext;
+
+	XftTextExtentsUtf8(dpy, f, (XftChar8 *) text, len, &ext);
+	return ext.xOff;
+	#endif // RASTER_PATCH
+}
+
+/* Returns r split into runs for the first len bytes of text. Runs built for a
+ * longer text starting with the same bytes are kept, the prefixes measured
+ * while shortening a title all use the runs of the whole title. */
+TextRuns *
+getruns(TextRuns *r, const char *text, int len)
+{
+	FcChar32 ucs;
+	TextRun *run;
+	int i, n, f, off;
+
+	if (r->len >= len && !memcmp(r->text, text, len))
+		return r;
+
+	if (len + 1 > r->size) {
+		r->size = len + 1;
+		r->text = erealloc(r->text, r->size);
+	}
+	memcpy(r->text, text, len);
+	r->text[len] = '\0';
+	r->len = len;
+	r->nrun = 0;
+
+	for (off = 0, f = 0; off < len; off += n) {
+		/* invalid bytes stay with the run they are in */
+		if ((n = FcUtf8ToUcs4((FcChar8 *)text + off, &ucs, len - off)) <= 0)
+			n = 1;
+		else
+			f = charfont(ucs);
+		if (r->nrun && r->run[r->nrun - 1].font == f) {
+			r->run[r->nrun - 1].len += n;
+			continue;
+		}
+		if (r->nrun == r->runcap) {
+			r->runcap = r->runcap ? r->runcap * 2 : 4;
+			r->run = erealloc(r->run, r->runcap * sizeof(*r->run));
+		}
+		run = &r->run[r->nrun++];
+		run->off = off;
+		run->len = n;
+		run->font = f;
+	}
+
+	for (i = 0; i < r->nrun; i++) {
+		run = &r->run[i];
+		run->w = fontwidth(runfont(run->font), r->text + run->off, run->len);
+	}
+
+	return r;
+}
+
+/* Asks fontconfig for a font like the configured one that has ucs. */
+XftFont *
+matchfont(FcChar32 ucs)
+{
+	FcCharSet *cs;
+	FcPattern *p, *match;
+	FcResult result;
+	XftFont *f = NULL;
+
+	if (!fallbackpat)
+		return NULL;
+
+	cs = FcCharSetCreate();
+	FcCharSetAddChar(cs, ucs);
+	p = FcPatternDuplicate(fallbackpat);
+	FcPatternAddCharSet(p, FC_CHARSET, cs);
+	FcPatternAddBool(p, FC_SCALABLE, FcTrue);
+	FcPatternAddBool(p, FC_COLOR, FcFalse);
+	FcConfigSubstitute(NULL, p, FcMatchPattern);
+	FcDefaultSubstitute(p);
+	match = FcFontMatch(NULL, p, &result);
+	FcCharSetDestroy(cs);
+	FcPatternDestroy(p);
+
+	if (match && !(f = XftFontOpenPattern(dpy, match)))
+		FcPatternDestroy(match);
+	if (f && !XftCharExists(dpy, f, ucs)) {
+		XftFontClose(dpy, f);
+		f = NULL;
+	}
+
+	return f;
+}
+
+XftFont *
+runfont(int font)
+{
+	return font ? fallbacks[font - 1] : dc.font.xfont;
+}
+
+/* Returns the width of the first len bytes of the runs, only the run cut by
+ * len is measured. */
+int
+runswidth(TextRuns *r, int len)
+{
+	TextRun *run;
+	int i, w = 0;
+
+	for (i = 0; i < r->nrun && r->run[i].off < len; i++) {
+		run = &r->run[i];
+		if (run->off + run->len <= len)
+			w += run->w;
+		else
+			w += fontwidth(runfont(run->font), r->text + run->off, len - run->off);
+	}
+
+	return w;
+}
+
+/* Returns runs for text, those of the tab being drawn if they cover it. */
+TextRuns *
+textruns(const char *text, int len)
+{
+	if (dc.runs && dc.runs->len >= len && !memcmp(dc.runs->text, text, len))
+		return dc.runs;
+	return getruns(&scratch, text, len);
+}
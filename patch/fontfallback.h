@@ -0,0 +1,25 @@
+#define FALLBACKMAX 16 /* fallback fonts kept open at most */
+
+typedef struct {
+	Bool used;
+	FcChar32 ucs;
+	int font; /* 0 for the font, i for fallbacks[i - 1] */
+} CharFont;
+
+static Bool addfallback(XftFont *f);
+static int charfont(FcChar32 ucs);
+static void drawruns(TextRuns *r, int x, int y, const XftColor *col, int len,
+                     const char *trim);
+static void fallbackfree(TextRuns *r);
+static void fallbackreset(const char *fontstr);
+static void fallbacktitle(int c);
+static void fallbacktitles(int from, int to);
+static int findfont(FcChar32 ucs);
+static void fonttext(XftFont *f, int x, int y, const XftColor *col,
+                     const char *text, int len);
+static int fontwidth(XftFont *f, const char *text, int len);
+static TextRuns *getruns(TextRuns *r, const char *text, int len);
+static XftFont *matchfont(FcChar32 ucs);
+static XftFont *runfont(int font);
+static int runswidth(TextRuns *r, int len);
+static TextRuns *textruns(const char *text, int len);
@@ -0,0 +1,131 @@
+/* Bar redraws are paced to at most one per refresh interval. An update that
+ * comes in before the next frame boundary only marks the frame as pending; all
+ * updates until the boundary are then drawn in one go. drawbar() syncs with
+ * the server, so there is never more than one frame outstanding. The interval
+ * is that of the RandR output showing most of the window, framerate is only
+ * used without RandR. */
+static Timer frametimer = { .func = framedraw };
+static long long nextframe;
+static Bool framepending;
+static FrameCrtc *crtcs;
+static int ncrtcs, randrevent = -1;
+static long framemhz; /* of the output showing the window, 0 if unknown */
+
+/* Reads the refresh rates of the active crtcs. */
+void
+framecrtcs(void)
+{
+	XRRScreenResources *res;
+	XRRCrtcInfo *ci;
+	XRRModeInfo *m;
+	unsigned long vtotal;
+	int i, j;
+
+	ncrtcs = 0;
+	if (!(res = XRRGetScreenResourcesCurrent(dpy, root)))
+		return;
+	crtcs = erealloc(crtcs, (res->ncrtc + 1) * sizeof(*crtcs));
+	for (i = 0; i < res->ncrtc; i++) {
+		if (!(ci = XRRGetCrtcInfo(dpy, res, res->crtcs[i])))
+			continue;
+		for (j = 0; ci->mode && j < res->nmode; j++) {
+			m = &res->modes[j];
+			if (m->id != ci->mode || !m->hTotal || !m->vTotal)
+				continue;
+			vtotal = m->vTotal;
+			if (m->modeFlags & RR_DoubleScan)
+				vtotal *= 2;
+			if (m->modeFlags & RR_Interlace)
+				vtotal /= 2;
+			crtcs[ncrtcs].x = ci->x;
+			crtcs[ncrtcs].y = ci->y;
+			crtcs[ncrtcs].w = ci->width;
+			crtcs[ncrtcs].h = ci->height;
+			crtcs[ncrtcs++].mhz = (long long)m->dotClock * 1000 / ((long long)m->hTotal * vtotal);
+			break;
+		}
+		XRRFreeCrtcInfo(ci);
+	}
+	XRRFreeScreenResources(res);
+}
+
+Bool
+framedefer(void)
+{
+	long long now = msnow(), interval;
+
+	if (framepending)
+		return True;
+	if (now < nextframe) {
+		framepending = True;
+		settimer(&frametimer, nextframe - now);
+		return True;
+	}
+	/* frames start on a fixed grid, like vblanks do */
+	interval = framemhz ? 1000000 / framemhz : 1000 / MAX(framerate, 1);
+	interval = MAX(interval, 1);
+	nextframe = (now / interval + 1) * interval;
+	return False;
+}
+
+void
+framedraw(void)
+{
+	framepending = False;
+	drawbar();
+}
+
+void
+frameinit(void)
+{
+	int err, major, minor;
+
+	if (!XRRQueryExtension(dpy, &randrevent, &err)
+	    || !XRRQueryVersion(dpy, &major, &minor)
+	    || (major == 1 && minor < 2)) { /* for the crtcs */
+		randrevent = -1;
+		return;
+	}
+	XRRSelectInput(dpy, root, RRScreenChangeNotifyMask | RRCrtcChangeNotifyMask);
+	framecrtcs();
+}
+
+/* Called when the window moved or was resized. */
+void
+frameoutput(void)
+{
+	Window child;
+	int i, x, y, w, h, area, best = 0;
+
+	framemhz = ncrtcs ? crtcs[0].mhz : 0;
+	/* the position only matters when the outputs differ */
+	for (i = 1; i < ncrtcs && crtcs[i].mhz == crtcs[0].mhz; i++);
+	if (i >= ncrtcs)
+		return;
+
+	XTranslateCoordinates(dpy, win, root, 0, 0, &x, &y, &child);
+	for (i = 0; i < ncrtcs; i++) {
+		w = MIN(x + ww, crtcs[i].x + crtcs[i].w) - MAX(x, crtcs[i].x);
+		h = MIN(y + wh, crtcs[i].y + crtcs[i].h) - MAX(y, crtcs[i].y);
+		if (w <= 0 || h <= 0 || (area = w * h) <= best)
+			continue;
+		best = area;
+		framemhz = crtcs[i].mhz;
+	}
+}
+
+Bool
+israndrevent(const XEvent *ev)
+{
+	return randrevent >= 0 && (ev->type == randrevent + RRScreenChangeNotify
+	                           || ev->type == randrevent + RRNotify);
+}
+
+/* Outputs were added, removed or changed their mode. */
+void
+randrnotify(const XEvent *e)
+{
+	XRRUpdateConfiguration((XEvent *)e);
+	framecrtcs();
+	frameoutput();
+}
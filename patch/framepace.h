@@ -0,0 +1,14 @@
+#include <X11/extensions/Xrandr.h>
+
+typedef struct {
+	int x, y, w, h;
+	long mhz; /* refresh rate in mHz */
+} FrameCrtc;
+
+static void framecrtcs(void);
+static Bool framedefer(void);
+static void framedraw(void);
+static void frameinit(void);
+static void frameoutput(void);
+static Bool israndrevent(const XEvent *ev);
+static void randrnotify(const XEvent *e);
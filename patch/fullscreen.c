@@ -0,0 +1,67 @@
+/* While the WM shows tabbed fullscreen the selected tab covers the bar and
+ * the compositor is asked to stop redirecting the window. Bar redraws, title
+ * fetches of the other tabs and icon updates wait until fullscreen ends, the
+ * other tabs keep their size until they are selected. */
+static Bool fullscreened;
+static int fullbh; /* bar height to restore */
+
+void
+fullscreenenter(void)
+{
+	long bypass = 1;
+
+	fullscreened = True;
+	drawhold++;
+	XChangeProperty(dpy, win, wmatom[WMBypassCompositor], XA_CARDINAL, 32,
+	                PropModeReplace, (unsigned char *)&bypass, 1);
+	fullbh = bh;
+	bh = 0;
+	if (sel > -1)
+		resize(sel, ww, wh);
+}
+
+void
+fullscreenleave(void)
+{
+	int c;
+
+	fullscreened = False;
+	XDeleteProperty(dpy, win, wmatom[WMBypassCompositor]);
+	bh = fullbh;
+	if (sel > -1)
+		resize(sel, ww, wh - bh);
+
+	for (c = 0; c < nclients; c++)
+		if (clients[c]->titlestale)
+			updatetitle(c);
+	#if ICON_PATCH
+	if (sel > -1)
+		xseticon();
+	#endif // ICON_PATCH
+	drawhold--;
+	drawpending = False;
+	drawbar();
+}
+
+/* Called when _NET_WM_STATE of tabbed changed. */
+void
+fullscreenstate(void)
+{
+	Atom type, *state = NULL;
+	unsigned long i, n, left;
+	int format;
+	Bool fs = False;
+
+	if (XGetWindowProperty(dpy, win, wmatom[WMState], 0L, 64L, False, XA_ATOM,
+	                       &type, &format, &n, &left, (unsigned char **)&state)
+	    == Success && state) {
+		for (i = 0; format == 32 && i < n; i++)
+			fs |= state[i] == wmatom[WMFullscreen];
+		XFree(state);
+	}
+
+	if (fs && !fullscreened)
+		fullscreenenter();
+	else if (!fs && fullscreened)
+		fullscreenleave();
+}
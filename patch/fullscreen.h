@@ -0,0 +1,3 @@
+static void fullscreenenter(void);
+static void fullscreenleave(void);
+static void fullscreenstate(void);
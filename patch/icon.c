@@ -1,41 +1,181 @@
 static unsigned long icon[ICON_WIDTH * ICON_HEIGHT + 2];
+static Window iconowner = None;  /* client whose icon is currently set on win */
+static unsigned long iconserial, iconpubserial;
+static Bool iconpixmapset = False;
+static Timer icontimer = { .func = iconretry };
+
+/* Caches a single image of the client's _NET_WM_ICON, see readicon(). Returns
+ * False if the icon is being fetched in the background instead. */
+Bool
+fetchicon(int c)
+{
+	Client *cl = clients[c];
+	unsigned long *data, len;
+	Pixmap pixmap, mask;
+
+	#if WORKER_PATCH
+	if (workerpost(JobIcon, c))
+		return False;
+	#endif // WORKER_PATCH
+	data = readicon(dpy, cl->win, &len, &pixmap, &mask);
+	storeicon(c, data, len, pixmap, mask);
+	return True;
+}
+
+/* Reads the smallest image of a _NET_WM_ICON that is at least iconsize pixels
+ * wide or else the largest one. Only the image headers are read to pick the
+ * size, so multi-resolution icons are not copied in full. Without an icon the
+ * legacy WM_HINTS icon pixmap is returned instead. */
+unsigned long *
+readicon(Display *d, Window w, unsigned long *len, Pixmap *pixmap, Pixmap *mask)
+{
+	Atom type;
+	XWMHints *wmh;
+	int format, iw, ih, bw = 0;
+	long offset = 0, best = -1, bestlen = 0;
+	unsigned long nitems, nleft, *icon = NULL;
+	unsigned char *data = NULL;
+
+	*len = 0;
+	*pixmap = *mask = None;
+	for (;;) {
+		if (XGetWindowProperty(d, w, wmatom[WMIcon], offset, 2, False,
+		                       XA_CARDINAL, &type, &format, &nitems, &nleft,
+		                       &data) != Success)
+			break;
+		if (type != XA_CARDINAL || format != 32 || nitems < 2) {
+			XFree(data);
+			break;
+		}
+		iw = ((unsigned long *)data)[0];
+		ih = ((unsigned long *)data)[1];
+		XFree(data);
+		/* an error reply, e.g. the window is gone, leaves data untouched */
+		data = NULL;
+		if (iw <= 0 || ih <= 0 || (unsigned long)iw * ih > nleft / 4)
+			break;
+
+		if (best < 0 || (bw < iconsize ? iw > bw : iw >= iconsize && iw < bw)) {
+			best = offset;
+			bestlen = 2 + (long)iw * ih;
+			bw = iw;
+		}
+		offset += 2 + iw * ih;
+		if (nleft / 4 == (unsigned long)iw * ih)
+			break;
+	}
+
+	if (best > -1) {
+		if (XGetWindowProperty(d, w, wmatom[WMIcon], best, bestlen,
+		                       False, XA_CARDINAL, &type, &format, &nitems,
+		                       &nleft, &data) == Success) {
+			if (type == XA_CARDINAL && format == 32 && nitems == bestlen) {
+				*len = bestlen;
+				icon = ecalloc(bestlen, sizeof(unsigned long));
+				memcpy(icon, data, bestlen * sizeof(unsigned long));
+			}
+			XFree(data);
+			data = NULL;
+		}
+	}
+
+	if (!icon && (wmh = XGetWMHints(d, w))) {
+		if (wmh->flags & IconPixmapHint) {
+			*pixmap = wmh->icon_pixmap;
+			if (wmh->flags & IconMaskHint)
+				*mask = wmh->icon_mask;
+		}
+		XFree(wmh);
+	}
+
+	return icon;
+}
+
+/* Takes over an icon returned by readicon() as the client's cached icon. */
+void
+storeicon(int c, unsigned long *data, unsigned long len, Pixmap pixmap, Pixmap mask)
+{
+	Client *cl = clients[c];
+
+	cl->icondirty = False;
+	cl->iconfetched = msnow();
+	cl->iconserial = ++iconserial;
+	free(cl->icon);
+	cl->icon = data;
+	cl->iconlen = len;
+	cl->iconpixmap = pixmap;
+	cl->iconmask = mask;
+	#if TABICONS_PATCH
+	if (cl->icon)
+		cl->iconhash = iconhash(cl->icon, cl->iconlen);
+	#endif // TABICONS_PATCH
+}
+
+void
+iconretry(void)
+{
+	if (sel > -1 && clients[sel]->icondirty)
+		xseticon();
+}
 
 void
 xseticon(void)
 {
-	Atom ret_type;
-	XWMHints *wmh, *cwmh;
-	int ret_format;
-	unsigned long ret_nitems, ret_nleft;
-	long offset = 0L;
-	unsigned char *data;
-
-	wmh = XGetWMHints(dpy, win);
-	wmh->flags &= ~(IconPixmapHint | IconMaskHint);
-	wmh->icon_pixmap = wmh->icon_mask = None;
+	Client *cl = clients[sel];
+	XWMHints *wmh;
+	long wait;
 
+	#if FULLSCREENBYPASS_PATCH
+	/* published once fullscreen ends */
+	if (fullscreened)
+		return;
+	#endif // FULLSCREENBYPASS_PATCH
+	if (cl->icondirty) {
+		/* rate limit clients that keep changing their icon, e.g. spinners */
+		wait = cl->iconfetched + iconrate - msnow();
+		if (cl->iconfetched && wait > 0 && iconowner == cl->win) {
+			settimer(&icontimer, wait);
+			return;
+		}
+		if (!fetchicon(sel))
+			return;
+	} else if (iconowner == cl->win && iconpubserial == cl->iconserial) {
+		return;
+	}
+	iconowner = cl->win;
+	iconpubserial = cl->iconserial;
 
-	if (XGetWindowProperty(dpy, clients[sel]->win, wmatom[WMIcon], offset, LONG_MAX, False,
-	                       XA_CARDINAL, &ret_type, &ret_format, &ret_nitems,
-	                       &ret_nleft, &data) == Success &&
-	    ret_type == XA_CARDINAL && ret_format == 32)
-	{
-		XChangeProperty(dpy, win, wmatom[WMIcon], XA_CARDINAL, 32,
-		                PropModeReplace, data, ret_nitems);
-	} else if ((cwmh = XGetWMHints(dpy, clients[sel]->win)) && cwmh->flags & IconPixmapHint) {
+	if (cl->icon || !cl->iconpixmap) {
+		XChangeProperty(dpy, win, wmatom[WMIcon], XA_CARDINAL, 32, PropModeReplace,
+		                cl->icon ? (unsigned char *)cl->icon : (unsigned char *)icon,
+		                cl->icon ? cl->iconlen : ICON_WIDTH * ICON_HEIGHT + 2);
+		if (!iconpixmapset)
+			return;
+	} else {
 		XDeleteProperty(dpy, win, wmatom[WMIcon]);
+	}
+
+	#if PROPCACHE_PATCH
+	if (!(wmh = gethints(-1)))
+	#else
+	if (!(wmh = XGetWMHints(dpy, win)))
+	#endif // PROPCACHE_PATCH
+		return;
+	wmh->flags &= ~(IconPixmapHint | IconMaskHint);
+	wmh->icon_pixmap = wmh->icon_mask = None;
+	if (!cl->icon && cl->iconpixmap) {
 		wmh->flags |= IconPixmapHint;
-		wmh->icon_pixmap = cwmh->icon_pixmap;
-		if (cwmh->flags & IconMaskHint) {
+		wmh->icon_pixmap = cl->iconpixmap;
+		if (cl->iconmask) {
 			wmh->flags |= IconMaskHint;
-			wmh->icon_mask = cwmh->icon_mask;
+			wmh->icon_mask = cl->iconmask;
 		}
-		XFree(cwmh);
-	} else {
-		XChangeProperty(dpy, win, wmatom[WMIcon], XA_CARDINAL, 32,
-		                PropModeReplace, (unsigned char *) icon, ICON_WIDTH * ICON_HEIGHT + 2);
 	}
+	iconpixmapset = (wmh->flags & IconPixmapHint) != 0;
+	#if PROPCACHE_PATCH
+	sethints(-1, wmh);
+	#else
 	XSetWMHints(dpy, win, wmh);
+	#endif // PROPCACHE_PATCH
 	XFree(wmh);
-	XFree(data);
-}
\ No newline at end of file
+}
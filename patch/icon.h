@@ -40,4 +40,8 @@ static const unsigned char ICON_pixel_data[16 * 16 * 4 + 1] =
  "\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\000\377\000\000\000\000\000\000\000"
  "\000\000\000\000\000\000\000\000\377\000\000\000\377";
 
+static Bool fetchicon(int c);
+static void iconretry(void);
+static unsigned long *readicon(Display *d, Window w, unsigned long *len, Pixmap *pixmap, Pixmap *mask);
+static void storeicon(int c, unsigned long *data, unsigned long len, Pixmap pixmap, Pixmap mask);
 static void xseticon(void);
\ No newline at end of file
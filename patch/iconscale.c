@@ -0,0 +1,135 @@
+/* Premultiply and box filter kernels of the tabicons patch. They only depend on
+ * the C library so that bench/iconscale.c can time them against a naive loop. */
+
+#if defined(__AVX2__)
+void
+premultiply8(uint32_t *px)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i amask = _mm256_set1_epi64x(0xffff000000000000LL);
+	const __m256i half = _mm256_set1_epi16(128);
+	__m256i v, lo, hi, alo, ahi;
+
+	v = _mm256_loadu_si256((__m256i *)px);
+	lo = _mm256_unpacklo_epi8(v, zero);
+	hi = _mm256_unpackhi_epi8(v, zero);
+	/* broadcast alpha over the channels of each pixel */
+	alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xff), 0xff);
+	ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xff), 0xff);
+	/* c * a / 255, rounded */
+	alo = _mm256_add_epi16(_mm256_mullo_epi16(lo, alo), half);
+	ahi = _mm256_add_epi16(_mm256_mullo_epi16(hi, ahi), half);
+	alo = _mm256_srli_epi16(_mm256_add_epi16(alo, _mm256_srli_epi16(alo, 8)), 8);
+	ahi = _mm256_srli_epi16(_mm256_add_epi16(ahi, _mm256_srli_epi16(ahi, 8)), 8);
+	/* keep the original alpha */
+	lo = _mm256_or_si256(_mm256_andnot_si256(amask, alo), _mm256_and_si256(amask, lo));
+	hi = _mm256_or_si256(_mm256_andnot_si256(amask, ahi), _mm256_and_si256(amask, hi));
+	_mm256_storeu_si256((__m256i *)px, _mm256_packus_epi16(lo, hi));
+}
+#endif // __AVX2__
+
+#if defined(__SSE2__)
+void
+premultiply4(uint32_t *px)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i amask = _mm_set1_epi64x(0xffff000000000000LL);
+	const __m128i half = _mm_set1_epi16(128);
+	__m128i v, lo, hi, alo, ahi;
+
+	v = _mm_loadu_si128((__m128i *)px);
+	lo = _mm_unpacklo_epi8(v, zero);
+	hi = _mm_unpackhi_epi8(v, zero);
+	alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xff), 0xff);
+	ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xff), 0xff);
+	alo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), half);
+	ahi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), half);
+	alo = _mm_srli_epi16(_mm_add_epi16(alo, _mm_srli_epi16(alo, 8)), 8);
+	ahi = _mm_srli_epi16(_mm_add_epi16(ahi, _mm_srli_epi16(ahi, 8)), 8);
+	lo = _mm_or_si128(_mm_andnot_si128(amask, alo), _mm_and_si128(amask, lo));
+	hi = _mm_or_si128(_mm_andnot_si128(amask, ahi), _mm_and_si128(amask, hi));
+	_mm_storeu_si128((__m128i *)px, _mm_packus_epi16(lo, hi));
+}
+#endif // __SSE2__
+
+/* Premultiplies ARGB32 pixels by their alpha. */
+void
+premultiply(uint32_t *px, int n)
+{
+	int i = 0;
+	uint32_t a;
+
+	#if defined(__AVX2__)
+	for (; i + 8 <= n; i += 8)
+		premultiply8(&px[i]);
+	#endif // __AVX2__
+	#if defined(__SSE2__)
+	for (; i + 4 <= n; i += 4)
+		premultiply4(&px[i]);
+	#endif // __SSE2__
+
+	for (; i < n; i++) {
+		a = px[i] >> 24;
+		#define MUL255(c) ((((c) * a + 128) + (((c) * a + 128) >> 8)) >> 8)
+		px[i] = a << 24
+		      | MUL255((px[i] >> 16) & 0xff) << 16
+		      | MUL255((px[i] >> 8) & 0xff) << 8
+		      | MUL255(px[i] & 0xff);
+		#undef MUL255
+	}
+}
+
+/* Box filter resampling of premultiplied ARGB32 pixels, averaging all source
+ * pixels that fall within each destination pixel. */
+void
+scaleicon(const uint32_t *src, int sw, int sh, uint32_t *dst, int dw, int dh, int stride)
+{
+	int x, y, sx, sy, x0, x1, y0, y1;
+	#if defined(__SSE2__)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sum, p;
+	__m128 f;
+	#else
+	uint32_t s[4], px;
+	#endif // __SSE2__
+
+	for (y = 0; y < dh; y++) {
+		y0 = y * sh / dh;
+		y1 = MAX(y0 + 1, (y + 1) * sh / dh);
+		for (x = 0; x < dw; x++) {
+			x0 = x * sw / dw;
+			x1 = MAX(x0 + 1, (x + 1) * sw / dw);
+			#if defined(__SSE2__)
+			sum = zero;
+			for (sy = y0; sy < y1; sy++) {
+				for (sx = x0; sx < x1; sx++) {
+					p = _mm_cvtsi32_si128(src[sy * sw + sx]);
+					p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(p, zero), zero);
+					sum = _mm_add_epi32(sum, p);
+				}
+			}
+			f = _mm_mul_ps(_mm_cvtepi32_ps(sum),
+			               _mm_set1_ps(1.0f / ((x1 - x0) * (y1 - y0))));
+			p = _mm_cvtps_epi32(f);
+			p = _mm_packs_epi32(p, zero);
+			dst[y * stride + x] = _mm_cvtsi128_si32(_mm_packus_epi16(p, zero));
+			#else
+			s[0] = s[1] = s[2] = s[3] = 0;
+			for (sy = y0; sy < y1; sy++) {
+				for (sx = x0; sx < x1; sx++) {
+					px = src[sy * sw + sx];
+					s[0] += px & 0xff;
+					s[1] += (px >> 8) & 0xff;
+					s[2] += (px >> 16) & 0xff;
+					s[3] += px >> 24;
+				}
+			}
+			px = (x1 - x0) * (y1 - y0);
+			dst[y * stride + x] = (s[3] + px / 2) / px << 24
+			                | (s[2] + px / 2) / px << 16
+			                | (s[1] + px / 2) / px << 8
+			                | (s[0] + px / 2) / px;
+			#endif // __SSE2__
+		}
+	}
+}
@@ -2,18 +2,91 @@
 #if BASENAME_PATCH
 #include "basename.c"
 #endif
+#if CLIENTLIST_PATCH
+#include "clientlist.c"
+#endif
+#if BULKOPS_PATCH
+#include "bulkops.c"
+#endif
+#if DAEMON_PATCH
+#include "daemon.c"
+#endif
+#if DAMAGEWATCH
+#include "damage.c"
+#endif
 #if DRAG_PATCH
 #include "drag.c"
 #endif
+#if EVENTPRIORITY_PATCH
+#include "eventprio.c"
+#endif
+#if FASTSTARTUP_PATCH
+#include "faststartup.c"
+#endif
+#if FRAMEPACE_PATCH
+#include "framepace.c"
+#endif
+#if FULLSCREENBYPASS_PATCH
+#include "fullscreen.c"
+#endif
 #if HIDETABS_PATCH
 #include "hidebar.c"
 #endif
+#if EVENTLOOP
+#include "eventloop.c"
+#endif
 #if ICON_PATCH
 #include "icon.c"
 #endif
+#if IPC_PATCH
+#include "ipc.c"
+#endif
 #if KEYRELEASE_PATCH
 #include "keyrelease.c"
 #endif
+#if LAYOUTCACHE_PATCH
+#include "layout.c"
+#endif
+#if POINTERCOMPRESS_PATCH
+#include "pointercompress.c"
+#endif
+#if PROPCACHE_PATCH
+#include "propcache.c"
+#endif
+#if RASTER_PATCH
+#include "raster.c"
+#endif
+#if ACTIVITY_PATCH
+#include "activity.c"
+#endif
+#if FONTFALLBACK_PATCH
+#include "fontfallback.c"
+#endif
+#if PROCSTATS_PATCH
+#include "procstats.c"
+#endif
+#if SIDEBAR_PATCH
+#include "sidebar.c"
+#endif
+#if SUPERVISE_PATCH
+#include "supervise.c"
+#endif
+#if SWITCHER_PATCH
+#include "switcher.c"
+#endif
+#if OVERVIEW_PATCH
+#include "overview.c"
+#endif
+#if LAZYTITLES_PATCH
+#include "lazytitles.c"
+#endif
+#if TABICONS_PATCH
+#include "iconscale.c"
+#include "tabicons.c"
+#endif
+#if WORKER_PATCH
+#include "worker.c"
+#endif
 #if XRESOURCES_PATCH
 #include "xresources.c"
 #endif
\ No newline at end of file
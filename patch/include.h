@@ -1,19 +1,122 @@
+/* Dependencies between patches */
+#if TABICONS_PATCH && !ICON_PATCH
+#error "the tabicons patch depends on the icon patch"
+#endif
+#if FITTABS_PATCH && !LAYOUTCACHE_PATCH
+#error "the fittabs patch depends on the layoutcache patch"
+#endif
+#if PROCSTATS_PATCH && !PROPCACHE_PATCH
+#error "the procstats patch depends on the propcache patch"
+#endif
+
+/* Patches that serve file descriptors or timers from the main event loop */
+#define EVENTLOOP (ACTIVITY_PATCH || EVENTPRIORITY_PATCH || FRAMEPACE_PATCH || ICON_PATCH || \
+                   IPC_PATCH || OVERVIEW_PATCH || POINTERCOMPRESS_PATCH || PROCSTATS_PATCH || \
+                   SUPERVISE_PATCH || WORKER_PATCH)
+
+/* Patches that watch file descriptors or arm timers from the event loop */
+#define FDWATCH (IPC_PATCH || SUPERVISE_PATCH || WORKER_PATCH)
+#define TIMERS (ACTIVITY_PATCH || FRAMEPACE_PATCH || ICON_PATCH || OVERVIEW_PATCH || \
+                (DRAG_PATCH && POINTERCOMPRESS_PATCH) || PROCSTATS_PATCH || SUPERVISE_PATCH || \
+                TABICONS_PATCH)
+
+/* Patches that watch the content of the client windows with Damage */
+#define DAMAGEWATCH (ACTIVITY_PATCH || OVERVIEW_PATCH)
+
+/* The daemon serves all containers from its own process unless a patch keeps
+ * state of its own for the window, then it forks a process per container */
+#define DAEMONSHARED (DAEMON_PATCH && !(EVENTLOOP || CLIENTLIST_PATCH || FASTSTARTUP_PATCH || \
+                      FULLSCREENBYPASS_PATCH || LAYOUTCACHE_PATCH || PROPCACHE_PATCH || \
+                      RASTER_PATCH || SIDEBAR_PATCH || SWITCHER_PATCH || XRESOURCES_RELOAD_PATCH))
+
 /* Patches */
+#if ACTIVITY_PATCH
+#include "activity.h"
+#endif
 #if BASENAME_PATCH
 #include "basename.h"
 #endif
+#if BULKOPS_PATCH
+#include "bulkops.h"
+#endif
+#if CLIENTLIST_PATCH
+#include "clientlist.h"
+#endif
+#if DAEMON_PATCH
+#include "daemon.h"
+#endif
+#if DAMAGEWATCH
+#include "damage.h"
+#endif
 #if DRAG_PATCH
 #include "drag.h"
 #endif
+#if EVENTPRIORITY_PATCH
+#include "eventprio.h"
+#endif
+#if FASTSTARTUP_PATCH
+#include "faststartup.h"
+#endif
+#if FONTFALLBACK_PATCH
+#include "fontfallback.h"
+#endif
+#if FRAMEPACE_PATCH
+#include "framepace.h"
+#endif
+#if FULLSCREENBYPASS_PATCH
+#include "fullscreen.h"
+#endif
 #if HIDETABS_PATCH
 #include "hidebar.h"
 #endif
+#if EVENTLOOP
+#include "eventloop.h"
+#endif
 #if ICON_PATCH
 #include "icon.h"
 #endif
+#if IPC_PATCH
+#include "ipc.h"
+#endif
 #if KEYRELEASE_PATCH
 #include "keyrelease.h"
 #endif
+#if LAYOUTCACHE_PATCH
+#include "layout.h"
+#endif
+#if LAZYTITLES_PATCH
+#include "lazytitles.h"
+#endif
+#if OVERVIEW_PATCH
+#include "overview.h"
+#endif
+#if POINTERCOMPRESS_PATCH
+#include "pointercompress.h"
+#endif
+#if PROCSTATS_PATCH
+#include "procstats.h"
+#endif
+#if PROPCACHE_PATCH
+#include "propcache.h"
+#endif
+#if RASTER_PATCH
+#include "raster.h"
+#endif
+#if SIDEBAR_PATCH
+#include "sidebar.h"
+#endif
+#if SUPERVISE_PATCH
+#include "supervise.h"
+#endif
+#if SWITCHER_PATCH
+#include "switcher.h"
+#endif
+#if TABICONS_PATCH
+#include "tabicons.h"
+#endif
+#if WORKER_PATCH
+#include "worker.h"
+#endif
 #if XRESOURCES_PATCH
 #include "xresources.h"
 #endif
\ No newline at end of file
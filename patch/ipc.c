@@ -0,0 +1,393 @@
+/* Control socket, one command per line:
+ *
+ *    list                       one "index window flags title" line per tab
+ *    info [tab]                 "pid class instance" of a tab (propcache patch)
+ *    latency                    "us count" lines of the input latency histogram
+ *    select <tab|+n|-n>         focus a tab, or rotate by n
+ *    move [tab] <pos>           move a tab (default selected) to position pos
+ *    spawn [args]               spawn the command, optionally appending args
+ *    close [tab]                close a tab
+ *    detach [tab]               hand a tab back to the window manager
+ *    set-title <tab> [title]    fix the title of a tab, no title to unfix
+ *
+ * where tab is an index, a window id (0x...) or "sel". Every command is
+ * answered with "ok" or "error <reason>". All complete lines received in one
+ * read are applied as a batch followed by a single redraw.
+ */
+static int ipcfd = -1;
+static char ipcpath[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static IpcConn *ipcconns;
+#if LAZYTITLES_PATCH
+static Bool ipclisting; /* every title is wanted while answering list */
+#endif // LAZYTITLES_PATCH
+
+void
+detachclient(int c)
+{
+	Window w = clients[c]->win;
+
+	XSelectInput(dpy, w, NoEventMask);
+	XUngrabKey(dpy, AnyKey, AnyModifier, w);
+	unmanage(c);
+
+	/* unmap first so that the window manager receives a MapRequest */
+	XUnmapWindow(dpy, w);
+	XReparentWindow(dpy, w, root, 0, 0);
+	XMapWindow(dpy, w);
+}
+
+void
+ipcaccept(int fd, short revents)
+{
+	IpcConn *ic;
+	int cfd;
+
+	while ((cfd = accept(fd, NULL, NULL)) >= 0) {
+		fcntl(cfd, F_SETFL, fcntl(cfd, F_GETFL) | O_NONBLOCK);
+		fcntl(cfd, F_SETFD, FD_CLOEXEC);
+		ic = ecalloc(1, sizeof(IpcConn));
+		ic->fd = cfd;
+		ic->next = ipcconns;
+		ipcconns = ic;
+		addwatch(cfd, POLLIN, ipcread);
+	}
+}
+
+void
+ipccleanup(void)
+{
+	while (ipcconns)
+		ipcclose(ipcconns);
+	if (ipcfd < 0)
+		return;
+	delwatch(ipcfd);
+	close(ipcfd);
+	unlink(ipcpath);
+	ipcfd = -1;
+}
+
+void
+ipcclose(IpcConn *ic)
+{
+	IpcConn **icp;
+
+	for (icp = &ipcconns; *icp && *icp != ic; icp = &(*icp)->next);
+	if (*icp)
+		*icp = ic->next;
+	delwatch(ic->fd);
+	close(ic->fd);
+	free(ic->out);
+	free(ic);
+}
+
+void
+ipcexec(IpcConn *ic, char *line)
+{
+	char *cmdname, *a, *b;
+	int c, pos;
+	Arg arg;
+
+	cmdname = ipcword(&line);
+	if (!*cmdname)
+		return;
+
+	if (!strcmp(cmdname, "list")) {
+		#if LAZYTITLES_PATCH
+		ipclisting = True;
+		refreshtitles(0, nclients);
+		ipclisting = False;
+		#endif // LAZYTITLES_PATCH
+		for (c = 0; c < nclients; c++) {
+			ipcreply(ic, "%d 0x%lx %c %s", c, clients[c]->win,
+			         c == sel ? '*' : clients[c]->urgent ? '!' : '-',
+			         clients[c]->name);
+		}
+	#if PROPCACHE_PATCH
+	} else if (!strcmp(cmdname, "info")) {
+		a = ipcword(&line);
+		if ((c = *a ? ipctab(a) : sel) < 0) {
+			ipcreply(ic, "error no such tab");
+			return;
+		}
+		clientclass(c);
+		ipcreply(ic, "%d %s %s", (int)clientpid(c),
+		         *clients[c]->class ? clients[c]->class : "-",
+		         *clients[c]->instance ? clients[c]->instance : "-");
+	#endif // PROPCACHE_PATCH
+	#if EVENTPRIORITY_PATCH
+	} else if (!strcmp(cmdname, "latency")) {
+		for (c = 0; c < LATENCYBUCKETS; c++)
+			if (latencyhist[c])
+				ipcreply(ic, "%lu %lu", c ? 1UL << c : 0, latencyhist[c]);
+	#endif // EVENTPRIORITY_PATCH
+	} else if (!strcmp(cmdname, "select")) {
+		a = ipcword(&line);
+		if (*a == '+' || *a == '-') {
+			arg.i = atoi(a);
+			rotate(&arg);
+		} else if ((c = ipctab(a)) > -1) {
+			focus(c);
+		} else {
+			ipcreply(ic, "error no such tab");
+			return;
+		}
+	} else if (!strcmp(cmdname, "move")) {
+		a = ipcword(&line);
+		b = ipcword(&line);
+		c = *b ? ipctab(a) : sel;
+		pos = atoi(*b ? b : a);
+		if (c < 0 || pos < 0 || pos >= nclients) {
+			ipcreply(ic, "error no such tab");
+			return;
+		}
+		ipcmovetab(c, pos);
+	} else if (!strcmp(cmdname, "spawn")) {
+		if (*line) {
+			cmd[cmd_append_pos] = line;
+			arg.v = cmd;
+			spawnchild(&arg, True);
+		} else {
+			spawn(NULL);
+		}
+	} else if (!strcmp(cmdname, "close") || !strcmp(cmdname, "detach")) {
+		if ((c = ipctab(ipcword(&line))) < 0) {
+			ipcreply(ic, "error no such tab");
+			return;
+		}
+		if (cmdname[0] == 'c')
+			closeclient(c);
+		else
+			detachclient(c);
+	} else if (!strcmp(cmdname, "set-title")) {
+		if ((c = ipctab(ipcword(&line))) < 0) {
+			ipcreply(ic, "error no such tab");
+			return;
+		}
+		clients[c]->fixedtitle = *line != '\0';
+		if (clients[c]->fixedtitle) {
+			snprintf(clients[c]->name, sizeof(clients[c]->name), "%s", line);
+			#if BASENAME_PATCH
+			clients[c]->basename = getbasename(clients[c]->name);
+			#endif // BASENAME_PATCH
+			#if CLIENTLIST_PATCH
+			titlesdirty = True;
+			#endif // CLIENTLIST_PATCH
+			#if FITTABS_PATCH
+			layouttitle(c);
+			#endif // FITTABS_PATCH
+			#if SWITCHER_PATCH
+			switcherupdate(c);
+			#endif // SWITCHER_PATCH
+			if (c == sel)
+				xsettitle(win, clients[c]->name);
+			drawbar();
+		} else {
+			updatetitle(c);
+		}
+	} else {
+		ipcreply(ic, "error unknown command '%s'", cmdname);
+		return;
+	}
+	ipcreply(ic, "ok");
+}
+
+void
+ipcflush(IpcConn *ic)
+{
+	ssize_t n;
+
+	while (ic->outlen) {
+		/* a client that went away must not take tabbed down with SIGPIPE */
+		if ((n = send(ic->fd, ic->out, ic->outlen, MSG_NOSIGNAL)) < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			ipcclose(ic);
+			return;
+		}
+		memmove(ic->out, ic->out + n, ic->outlen - n);
+		ic->outlen -= n;
+	}
+
+	if (!ic->outlen && ic->eof)
+		ipcclose(ic);
+	else
+		setwatch(ic->fd, ic->outlen ? POLLIN | POLLOUT : POLLIN);
+}
+
+void
+ipcinit(void)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	const char *dir = getenv("XDG_RUNTIME_DIR");
+	mode_t mask;
+	int n;
+
+	n = snprintf(ipcpath, sizeof(ipcpath), "%s/", dir && *dir ? dir : "/tmp");
+	snprintf(ipcpath + n, sizeof(ipcpath) - n, ipcsockpath, winid);
+	snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", ipcpath);
+
+	if ((ipcfd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+		fprintf(stderr, "%s: cannot create ipc socket\n", argv0);
+		return;
+	}
+	fcntl(ipcfd, F_SETFL, fcntl(ipcfd, F_GETFL) | O_NONBLOCK);
+	fcntl(ipcfd, F_SETFD, FD_CLOEXEC);
+
+	/* the socket is created accessible to the user only */
+	unlink(ipcpath);
+	mask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+	n = bind(ipcfd, (struct sockaddr *)&addr, sizeof(addr));
+	umask(mask);
+	if (n < 0 || listen(ipcfd, SOMAXCONN) < 0) {
+		fprintf(stderr, "%s: cannot listen on '%s'\n", argv0, ipcpath);
+		close(ipcfd);
+		ipcfd = -1;
+		return;
+	}
+
+	addwatch(ipcfd, POLLIN, ipcaccept);
+	setenv("TABBED_SOCKET", ipcpath, 1);
+}
+
+void
+ipcmovetab(int from, int to)
+{
+	Client *c = clients[from];
+
+	if (from == to)
+		return;
+
+	if (from < to)
+		memmove(&clients[from], &clients[from + 1],
+		        sizeof(Client *) * (to - from));
+	else
+		memmove(&clients[to + 1], &clients[to],
+		        sizeof(Client *) * (from - to));
+	clients[to] = c;
+	#if FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	fallbacktitles(MIN(from, to), MAX(from, to) + 1);
+	#endif // FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	#if CLIENTLIST_PATCH
+	clientsdirty = titlesdirty = True;
+	#endif // CLIENTLIST_PATCH
+
+	#define MOVEDINDEX(i) ((i) == from ? to : \
+	                       from < to && (i) > from && (i) <= to ? (i) - 1 : \
+	                       from > to && (i) >= to && (i) < from ? (i) + 1 : (i))
+	sel = MOVEDINDEX(sel);
+	lastsel = MOVEDINDEX(lastsel);
+	#undef MOVEDINDEX
+
+	drawbar();
+}
+
+void
+ipcread(int fd, short revents)
+{
+	IpcConn *ic;
+	char *line, *end;
+	ssize_t n;
+
+	for (ic = ipcconns; ic && ic->fd != fd; ic = ic->next);
+	if (!ic)
+		return;
+
+	if (revents & (POLLERR | POLLNVAL)) {
+		ipcclose(ic);
+		return;
+	}
+
+	if (revents & (POLLIN | POLLHUP)) {
+		/* a full buffer is read again once its complete lines are applied */
+		while (ic->inlen < sizeof(ic->in) - 1) {
+			if ((n = read(fd, ic->in + ic->inlen, sizeof(ic->in) - ic->inlen - 1)) > 0) {
+				ic->inlen += n;
+				continue;
+			}
+			if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+				ic->eof = True;
+			break;
+		}
+		ic->in[ic->inlen] = '\0';
+
+		/* apply all complete lines with a single redraw at the end */
+		drawhold++;
+		for (line = ic->in; (end = strchr(line, '\n')); line = end + 1) {
+			*end = '\0';
+			ipcexec(ic, line);
+		}
+		ic->inlen -= line - ic->in;
+		if (ic->eof && ic->inlen) {
+			ipcexec(ic, line);
+			ic->inlen = 0;
+		}
+		if (--drawhold == 0 && drawpending) {
+			drawpending = False;
+			drawbar();
+		}
+
+		memmove(ic->in, line, ic->inlen);
+		if (ic->inlen == sizeof(ic->in) - 1) {
+			ipcreply(ic, "error line too long");
+			ic->inlen = 0;
+			ic->eof = True;
+		}
+	}
+
+	ipcflush(ic);
+}
+
+void
+ipcreply(IpcConn *ic, const char *fmt, ...)
+{
+	va_list ap;
+	size_t len;
+	char *p;
+
+	va_start(ap, fmt);
+	len = vsnprintf(NULL, 0, fmt, ap) + 1;
+	va_end(ap);
+
+	if (ic->outlen + len + 1 > ic->outsize) {
+		ic->outsize = (ic->outlen + len + 1) * 2;
+		ic->out = erealloc(ic->out, ic->outsize);
+	}
+
+	va_start(ap, fmt);
+	vsnprintf(ic->out + ic->outlen, len, fmt, ap);
+	va_end(ap);
+
+	/* keep replies on a single line each */
+	for (p = ic->out + ic->outlen; *p; p++)
+		if (*p == '\n')
+			*p = ' ';
+	ic->outlen += len - 1;
+	ic->out[ic->outlen++] = '\n';
+}
+
+char *
+ipcword(char **s)
+{
+	char *w = *s + strspn(*s, " \t");
+
+	*s = w + strcspn(w, " \t");
+	if (**s)
+		*(*s)++ = '\0';
+	*s += strspn(*s, " \t");
+	return w;
+}
+
+int
+ipctab(const char *s)
+{
+	char *end;
+	long i;
+
+	if (!s || !*s || !strcmp(s, "sel"))
+		return sel;
+	if (!strncmp(s, "0x", 2))
+		return getclient(strtoul(s, NULL, 0));
+
+	i = strtol(s, &end, 10);
+	return *end || i < 0 || i >= nclients ? -1 : i;
+}
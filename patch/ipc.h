@@ -0,0 +1,30 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define IPC_LINE_MAX 4096
+
+typedef struct IpcConn IpcConn;
+struct IpcConn {
+	int fd;
+	char in[IPC_LINE_MAX];
+	size_t inlen;
+	char *out;
+	size_t outlen, outsize;
+	Bool eof;
+	IpcConn *next;
+};
+
+static void detachclient(int c);
+static void ipcaccept(int fd, short revents);
+static void ipccleanup(void);
+static void ipcclose(IpcConn *ic);
+static void ipcexec(IpcConn *ic, char *line);
+static void ipcflush(IpcConn *ic);
+static void ipcinit(void);
+static void ipcmovetab(int from, int to);
+static void ipcread(int fd, short revents);
+static void ipcreply(IpcConn *ic, const char *fmt, ...);
+static int ipctab(const char *s);
+static char *ipcword(char **s);
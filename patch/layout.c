@@ -0,0 +1,216 @@
+/* The bar layout only changes with the window width, the number of tabs, the
+ * selection, the tab width or the font, so it is computed once and reused by
+ * drawbar() and hit testing. The widths of before and after
+ * are measured once per font. */
+static Layout layout;
+static int beforew = -1, afterw;
+#if FITTABS_PATCH
+static int digitw, colonw;
+
+/* Sizes every tab to its title and packs as many tabs around the selected
+ * one as fit. Space that is left over is shared by the visible tabs. A
+ * selected tab wider than the bar is cut to the bar. */
+void
+fitlayout(Layout *l)
+{
+	int i, lo, hi, w, selw = 0, used, avail, extra, x;
+	Bool grew;
+
+	if (nclients > l->size) {
+		l->size = nclients;
+		l->x = erealloc(l->x, sizeof(int) * l->size);
+	}
+
+	/* first try without arrows, then make room for both */
+	for (i = 0; i < 2; i++) {
+		avail = ww - (i ? beforew + afterw : 0);
+		lo = MAX(sel, 0);
+		hi = lo - 1;
+		used = 0;
+		if (nclients) {
+			hi = lo;
+			used = selw = MIN(fitwidth(lo), MAX(avail, 0));
+		}
+		do {
+			grew = False;
+			if (hi + 1 < nclients && used + (w = fitwidth(hi + 1)) <= avail) {
+				used += w;
+				hi++;
+				grew = True;
+			}
+			if (lo > 0 && used + (w = fitwidth(lo - 1)) <= avail) {
+				used += w;
+				lo--;
+				grew = True;
+			}
+		} while (grew);
+		if (lo == 0 && hi == nclients - 1)
+			break;
+	}
+
+	l->fc = lo;
+	l->cc = hi - lo + 1;
+	l->beforew = lo > 0 ? beforew : 0;
+	l->afterw = hi < nclients - 1 ? afterw : 0;
+	if (!l->cc)
+		return;
+
+	extra = ww - l->beforew - l->afterw - used;
+	for (i = 0, x = l->beforew; i < l->cc; i++) {
+		x += (lo + i == MAX(sel, 0) ? selw : fitwidth(lo + i)) + extra / l->cc;
+		if (lo + i == sel)
+			x += extra % l->cc;
+		l->x[i] = x;
+	}
+}
+
+/* Returns the width tab c asks for, only measuring its title when that
+ * changed since the last call. */
+int
+fitwidth(int c)
+{
+	Client *cl = clients[c];
+	const char *t;
+	int w;
+	#if CLIENTNUMBER_PATCH
+	int n;
+	#endif // CLIENTNUMBER_PATCH
+
+	if (!cl->titlew) {
+		#if BASENAME_PATCH
+		t = basenametitles ? cl->basename : cl->name;
+		#else
+		t = cl->name;
+		#endif // BASENAME_PATCH
+		cl->titlew = MAX(1, textnw(t, strlen(t)));
+	}
+	w = cl->titlew + dc.font.height;
+	#if CLIENTNUMBER_PATCH
+	for (n = c + 1; n; n /= 10)
+		w += digitw;
+	w += colonw;
+	#endif // CLIENTNUMBER_PATCH
+	#if TABICONS_PATCH
+	w += dc.h - 1;
+	#if SEPARATOR_PATCH
+	w += separator;
+	#endif // SEPARATOR_PATCH
+	#endif // TABICONS_PATCH
+
+	return MAX(mintabwidth, MIN(w, maxtabwidth));
+}
+#endif // FITTABS_PATCH
+
+Layout *
+getlayout(void)
+{
+	Layout *l = &layout;
+	#if !FITTABS_PATCH
+	int i, cc, width, ret;
+	#endif // FITTABS_PATCH
+
+	if (l->valid && l->ww == ww && l->nclients == nclients && l->sel == sel
+	    && l->tabwidth == tabwidth)
+		return l;
+
+	if (beforew < 0) {
+		beforew = TEXTW(before);
+		afterw = TEXTW(after);
+		#if FITTABS_PATCH
+		digitw = textnw("0", 1);
+		colonw = textnw(": ", 2);
+		#endif // FITTABS_PATCH
+	}
+	l->valid = True;
+	l->ww = ww;
+	l->nclients = nclients;
+	l->sel = sel;
+	l->tabwidth = tabwidth;
+
+	#if FITTABS_PATCH
+	fitlayout(l);
+	#else
+	cc = ww / MAX(tabwidth, 1);
+	if (nclients > cc)
+		cc = (ww - beforew - afterw) / MAX(tabwidth, 1);
+	if (sel < 0) {
+		l->fc = 0;
+	} else {
+		ret = sel - cc / 2 + (cc + 1) % 2;
+		l->fc = ret < 0 ? 0 :
+		        ret + cc > nclients ? MAX(0, nclients - cc) :
+		        ret;
+	}
+	l->afterw = l->fc + cc < nclients ? afterw : 0;
+	l->beforew = l->fc > 0 ? beforew : 0;
+	l->cc = MAX(0, MIN(cc, nclients));
+
+	if (l->cc > l->size) {
+		l->size = l->cc;
+		l->x = erealloc(l->x, sizeof(int) * l->size);
+	}
+	width = ww - l->beforew - l->afterw;
+	for (i = 0; i < l->cc; i++) {
+		l->x[i] = (i ? l->x[i - 1] : l->beforew) + width / l->cc;
+		if (l->fc + i == sel)
+			l->x[i] += width % l->cc;
+	}
+	#endif // FITTABS_PATCH
+
+	return l;
+}
+
+#if !SIDEBAR_PATCH
+/* Returns the visible tab at x or -1. */
+int
+layouthit(int x)
+{
+	Layout *l = getlayout();
+	int lo = 0, hi = l->cc, mid;
+
+	if (x < l->beforew)
+		return -1;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (l->x[mid] > x)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo < l->cc ? l->fc + lo : -1;
+}
+#endif // SIDEBAR_PATCH
+
+/* Called when the font or the arrows change. */
+void
+layoutreset(void)
+{
+	#if FITTABS_PATCH
+	int c;
+
+	for (c = 0; c < nclients; c++)
+		clients[c]->titlew = 0;
+	#endif // FITTABS_PATCH
+	layout.valid = False;
+	beforew = -1;
+}
+#if FITTABS_PATCH
+
+/* Called when the title of tab c changed. Only that title is measured again
+ * and the layout is kept when the width of the tab stays the same. */
+void
+layouttitle(int c)
+{
+	int w;
+
+	if (beforew < 0 || !clients[c]->titlew) {
+		clients[c]->titlew = 0;
+		layout.valid = False;
+		return;
+	}
+	w = fitwidth(c);
+	clients[c]->titlew = 0;
+	if (fitwidth(c) != w)
+		layout.valid = False;
+}
+#endif // FITTABS_PATCH
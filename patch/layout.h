@@ -0,0 +1,21 @@
+typedef struct {
+	Bool valid;
+	int ww, nclients, sel, tabwidth; /* state the layout was computed for */
+	int beforew, afterw;             /* arrow widths, 0 when not shown */
+	int fc, cc;                      /* first visible tab and their number */
+	int *x;                          /* right edge of every visible tab */
+	int size;
+} Layout;
+
+#if FITTABS_PATCH
+static void fitlayout(Layout *l);
+static int fitwidth(int c);
+#endif // FITTABS_PATCH
+static Layout *getlayout(void);
+#if !SIDEBAR_PATCH
+static int layouthit(int x);
+#endif // SIDEBAR_PATCH
+static void layoutreset(void);
+#if FITTABS_PATCH
+static void layouttitle(int c);
+#endif // FITTABS_PATCH
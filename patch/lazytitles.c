@@ -0,0 +1,60 @@
+/* Titles are only fetched for the selected tab and the tabs that fit in the
+ * bar. A title change of any other tab just marks its title as stale, it is
+ * fetched once the tab scrolls into view or the switcher or an ipc list
+ * needs it. */
+void
+refreshtitles(int from, int to)
+{
+	int c;
+
+	/* the caller redraws */
+	drawhold++;
+	for (c = MAX(from, 0); c < MIN(to, nclients); c++)
+		if (clients[c]->titlestale)
+			updatetitle(c);
+	drawhold--;
+}
+
+Bool
+titlewanted(int c)
+{
+	int fc, cc;
+
+	if (c == sel)
+		return True;
+	#if SWITCHER_PATCH
+	if (switching)
+		return True;
+	#endif // SWITCHER_PATCH
+	#if OVERVIEW_PATCH
+	if (overviewing)
+		return True;
+	#endif // OVERVIEW_PATCH
+	#if IPC_PATCH
+	if (ipclisting)
+		return True;
+	#endif // IPC_PATCH
+	#if AWESOMEBAR_PATCH
+	/* every tab gets a share of the bar */
+	return True;
+	#endif // AWESOMEBAR_PATCH
+	#if AUTOHIDE_PATCH || HIDETABS_PATCH
+	if (!bh)
+		return False;
+	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
+
+	/* same range as drawbar() */
+	#if SIDEBAR_PATCH
+	return sidebary(c) > -dc.h && sidebary(c) < wh;
+	#elif LAYOUTCACHE_PATCH
+	fc = getlayout()->fc;
+	cc = getlayout()->cc;
+	#else
+	cc = ww / tabwidth;
+	if (nclients > cc)
+		cc = (ww - TEXTW(before) - TEXTW(after)) / tabwidth;
+	fc = getfirsttab();
+	#endif // LAYOUTCACHE_PATCH
+
+	return c >= fc && c < fc + cc;
+}
@@ -0,0 +1,2 @@
+static void refreshtitles(int from, int to);
+static Bool titlewanted(int c);
@@ -0,0 +1,358 @@
+/* All tabs are shown as a grid of thumbnails in a window covering tabbed. The
+ * named pixmap of every client window is scaled with XRender into a thumbnail
+ * picture kept per client. A thumbnail is only rendered again after Damage
+ * reported a change to its window (see damage.c), and then at most every
+ * thumbrate ms for background tabs, so opening the overview only composites
+ * the cached pictures. */
+static Bool overviewing, overviewok;
+static Window ovwin;
+static int ovsel, ovcols, ovrows, ovcellw, ovcellh, ovw, ovh;
+static int renderop, rendererr;
+static Timer thumbtimer = { .func = thumbtick };
+
+void
+drawoverview(void)
+{
+	XRenderPictFormat *fmt;
+	XTransform xf = {{{ 0 }}};
+	Picture pict;
+	XftColor *col;
+	Client *cl;
+	int c, x, y, w, h, tw, th, oy = dc.y;
+	#if RASTER_PATCH
+	const Renderer *r = render;
+	#endif // RASTER_PATCH
+
+	if (!nclients) {
+		overviewstop();
+		return;
+	}
+
+	if (ovw != ww || ovh != wh) {
+		XResizeWindow(dpy, ovwin, ww, wh);
+		ovw = ww;
+		ovh = wh;
+	}
+	/* a tab focused meanwhile is raised above the overview */
+	XRaiseWindow(dpy, ovwin);
+
+	#if RASTER_PATCH
+	/* the raster backend only holds the bar, draw into the pixmap instead */
+	render = &corerenderer;
+	#endif // RASTER_PATCH
+	#if ALPHA_PATCH
+	fmt = XRenderFindVisualFormat(dpy, visual);
+	#else
+	fmt = XRenderFindVisualFormat(dpy, DefaultVisual(dpy, screen));
+	#endif // ALPHA_PATCH
+	pict = XRenderCreatePicture(dpy, dc.drawable, fmt, 0, NULL);
+
+	XSetForeground(dpy, dc.gc, dc.norm[ColBG].pixel);
+	XFillRectangle(dpy, dc.drawable, dc.gc, 0, 0, ww, wh);
+	overviewgrid();
+	ovsel = MAX(0, MIN(ovsel, nclients - 1));
+	xf.matrix[2][2] = XDoubleToFixed(1);
+
+	for (c = 0; c < nclients; c++) {
+		cl = clients[c];
+		x = (c % ovcols) * ovcellw;
+		y = (c / ovcols) * ovcellh;
+		if (c == ovsel) {
+			col = dc.sel;
+			XSetForeground(dpy, dc.gc, dc.sel[ColBG].pixel);
+			XFillRectangle(dpy, dc.drawable, dc.gc, x, y, ovcellw, ovcellh);
+		} else {
+			col = cl->urgent ? dc.urg : dc.norm;
+		}
+
+		/* the thumbnail keeps its aspect and is centred above the title */
+		w = ovcellw - 2 * OVERVIEWPAD;
+		h = ovcellh - 2 * OVERVIEWPAD - dc.h;
+		if (cl->thumb && w > 0 && h > 0) {
+			tw = w;
+			th = (long)w * cl->thumbh / cl->thumbw;
+			if (th > h) {
+				th = h;
+				tw = (long)h * cl->thumbw / cl->thumbh;
+			}
+			tw = MAX(tw, 1);
+			th = MAX(th, 1);
+			xf.matrix[0][0] = XDoubleToFixed((double)cl->thumbw / tw);
+			xf.matrix[1][1] = XDoubleToFixed((double)cl->thumbh / th);
+			XRenderSetPictureTransform(dpy, cl->thumb, &xf);
+			XRenderComposite(dpy, PictOpOver, cl->thumb, None, pict,
+			                 0, 0, 0, 0, x + (ovcellw - tw) / 2,
+			                 y + OVERVIEWPAD + (h - th) / 2, tw, th);
+		}
+
+		dc.x = x + OVERVIEWPAD;
+		dc.y = y + ovcellh - OVERVIEWPAD - dc.h;
+		dc.w = ovcellw - 2 * OVERVIEWPAD;
+		if (dc.w <= 0)
+			continue;
+		#if TABICONS_PATCH
+		dc.icon = tabicon(c);
+		#endif // TABICONS_PATCH
+		drawtext(cl->name, col);
+		#if TABICONS_PATCH
+		dc.icon = None;
+		#endif // TABICONS_PATCH
+	}
+	dc.y = oy;
+
+	XRenderFreePicture(dpy, pict);
+	#if RASTER_PATCH
+	render = r;
+	#endif // RASTER_PATCH
+	XCopyArea(dpy, dc.drawable, ovwin, dc.gc, 0, 0, ww, wh, 0, 0);
+	XSync(dpy, False);
+}
+
+void
+overview(const Arg *arg)
+{
+	XSetWindowAttributes wa = {
+		.event_mask = ButtonPressMask | ExposureMask | KeyPressMask,
+	};
+	int c, n;
+
+	if (overviewing || !overviewok || !nclients)
+		return;
+	#if SWITCHER_PATCH
+	if (switching)
+		return;
+	#endif // SWITCHER_PATCH
+	#if FULLSCREENBYPASS_PATCH
+	if (fullscreened)
+		return;
+	#endif // FULLSCREENBYPASS_PATCH
+
+	if (!ovwin) {
+		ovwin = XCreateWindow(dpy, win, 0, 0, ww, wh, 0, CopyFromParent,
+		                      InputOutput, CopyFromParent, CWEventMask, &wa);
+		ovw = ww;
+		ovh = wh;
+	}
+	XMapRaised(dpy, ovwin);
+	if (XGrabKeyboard(dpy, ovwin, True, GrabModeAsync, GrabModeAsync,
+	                  CurrentTime) != GrabSuccess) {
+		XUnmapWindow(dpy, ovwin);
+		return;
+	}
+
+	overviewing = True;
+	ovsel = sel;
+	#if LAZYTITLES_PATCH
+	refreshtitles(0, nclients);
+	#endif // LAZYTITLES_PATCH
+	drawoverview();
+
+	/* only tabs that were never rendered hold up the overview */
+	for (c = n = 0; c < nclients; c++) {
+		if (!clients[c]->thumb) {
+			thumbrender(clients[c]);
+			n++;
+		}
+	}
+	if (n)
+		drawoverview();
+}
+
+void
+overviewclick(int x, int y)
+{
+	int c;
+
+	if (x < 0 || y < 0 || !ovcellw || !ovcellh || x / ovcellw >= ovcols)
+		return;
+	if ((c = y / ovcellh * ovcols + x / ovcellw) >= nclients)
+		return;
+	overviewstop();
+	focus(c);
+}
+
+/* Naming the pixmap of a window races with the client destroying it. */
+Bool
+overviewerror(XErrorEvent *ee)
+{
+	return overviewok && ee->request_code == renderop &&
+	       (ee->error_code == BadPixmap || ee->error_code == BadDrawable ||
+	        ee->error_code == rendererr + BadPicture);
+}
+
+/* Picks the number of columns that gives the largest thumbnails. */
+void
+overviewgrid(void)
+{
+	int cols, rows, w, h, s, best = -1;
+
+	for (cols = 1; cols <= nclients; cols++) {
+		rows = (nclients + cols - 1) / cols;
+		w = ww / cols - 2 * OVERVIEWPAD;
+		h = wh / rows - 2 * OVERVIEWPAD - dc.h;
+		s = MIN(w, (long)h * ww / MAX(wh, 1));
+		if (s > best) {
+			best = s;
+			ovcols = cols;
+			ovrows = rows;
+		}
+	}
+	ovcellw = ww / ovcols;
+	ovcellh = wh / ovrows;
+}
+
+void
+overviewinit(void)
+{
+	int ev;
+
+	overviewok = damageok &&
+	             XQueryExtension(dpy, RENDER_NAME, &renderop, &ev, &rendererr);
+}
+
+void
+overviewkey(XKeyEvent *ev)
+{
+	char buf[32];
+	KeySym ksym = NoSymbol;
+	int c;
+
+	XLookupString(ev, buf, sizeof(buf), &ksym, NULL);
+
+	switch (ksym) {
+	case XK_Escape:
+		overviewstop();
+		return;
+	case XK_Return:
+	case XK_KP_Enter:
+		c = ovsel;
+		overviewstop();
+		focus(c);
+		return;
+	case XK_Tab:
+	case XK_Right:
+		ovsel = (ovsel + 1) % nclients;
+		break;
+	case XK_ISO_Left_Tab:
+	case XK_Left:
+		ovsel = (ovsel + nclients - 1) % nclients;
+		break;
+	case XK_Down:
+		if (ovsel + ovcols < nclients)
+			ovsel += ovcols;
+		break;
+	case XK_Up:
+		if (ovsel >= ovcols)
+			ovsel -= ovcols;
+		break;
+	default:
+		return;
+	}
+	drawoverview();
+}
+
+void
+overviewstop(void)
+{
+	XUngrabKeyboard(dpy, CurrentTime);
+	XUnmapWindow(dpy, ovwin);
+	overviewing = False;
+	#if SIDEBAR_PATCH
+	/* the overview was drawn over the rows kept in the pixmap */
+	sidebarreset();
+	#endif // SIDEBAR_PATCH
+	drawbar();
+}
+
+long long
+thumbdue(Client *c)
+{
+	if (sel > -1 && clients[sel] == c)
+		return c->thumbtime + thumbrate / 10;
+	return c->thumbtime + thumbrate;
+}
+
+void
+thumbfree(Client *c)
+{
+	if (c->thumb)
+		XRenderFreePicture(dpy, c->thumb);
+	c->thumb = None;
+}
+
+void
+thumbrender(Client *c)
+{
+	XRenderPictureAttributes pa = { .subwindow_mode = IncludeInferiors };
+	XTransform xf = {{{ 0 }}};
+	XWindowAttributes wa;
+	XRenderPictFormat *fmt;
+	Picture src;
+	Pixmap pm;
+	int tw, th;
+
+	c->thumbdirty = False;
+	c->thumbtime = msnow();
+
+	/* an unmapped tabbed reports damage again once it is shown */
+	if (!XGetWindowAttributes(dpy, c->win, &wa) || wa.map_state != IsViewable
+	    || !(fmt = XRenderFindVisualFormat(dpy, wa.visual)))
+		return;
+
+	tw = MAX(thumbwidth, 1);
+	th = MAX((long)tw * wa.height / MAX(wa.width, 1), 1);
+	if (!c->thumb || c->thumbw != tw || c->thumbh != th) {
+		if (c->thumb)
+			XRenderFreePicture(dpy, c->thumb);
+		pm = XCreatePixmap(dpy, win, tw, th, 32);
+		c->thumb = XRenderCreatePicture(dpy, pm,
+		           XRenderFindStandardFormat(dpy, PictStandardARGB32), 0, NULL);
+		XFreePixmap(dpy, pm);
+		XRenderSetPictureFilter(dpy, c->thumb, FilterBilinear, NULL, 0);
+		c->thumbw = tw;
+		c->thumbh = th;
+	}
+
+	pm = XCompositeNameWindowPixmap(dpy, c->win);
+	src = XRenderCreatePicture(dpy, pm, fmt, CPSubwindowMode, &pa);
+	xf.matrix[0][0] = XDoubleToFixed((double)wa.width / tw);
+	xf.matrix[1][1] = XDoubleToFixed((double)wa.height / th);
+	xf.matrix[2][2] = XDoubleToFixed(1);
+	XRenderSetPictureTransform(dpy, src, &xf);
+	XRenderSetPictureFilter(dpy, src, FilterBilinear, NULL, 0);
+	XRenderComposite(dpy, PictOpSrc, src, None, c->thumb, 0, 0, 0, 0, 0, 0, tw, th);
+	XRenderFreePicture(dpy, src);
+	XFreePixmap(dpy, pm);
+}
+
+void
+thumbschedule(Client *c)
+{
+	long long due = thumbdue(c);
+
+	if (!thumbtimer.expires || due < thumbtimer.expires)
+		settimer(&thumbtimer, due - msnow());
+}
+
+void
+thumbtick(void)
+{
+	long long now = msnow(), due, next = 0;
+	Bool drawn = False;
+	int c;
+
+	for (c = 0; c < nclients; c++) {
+		if (!clients[c]->thumbdirty)
+			continue;
+		if ((due = thumbdue(clients[c])) <= now) {
+			thumbrender(clients[c]);
+			drawn = True;
+		} else if (!next || due < next) {
+			next = due;
+		}
+	}
+	if (next)
+		settimer(&thumbtimer, next - now);
+	if (drawn && overviewing)
+		drawoverview();
+}
@@ -0,0 +1,17 @@
+#include <X11/extensions/Xrender.h>
+
+#define OVERVIEWPAD 8 /* space around every thumbnail, in pixels */
+
+static void drawoverview(void);
+static void overview(const Arg *arg);
+static void overviewclick(int x, int y);
+static Bool overviewerror(XErrorEvent *ee);
+static void overviewgrid(void);
+static void overviewinit(void);
+static void overviewkey(XKeyEvent *ev);
+static void overviewstop(void);
+static long long thumbdue(Client *c);
+static void thumbfree(Client *c);
+static void thumbrender(Client *c);
+static void thumbschedule(Client *c);
+static void thumbtick(void);
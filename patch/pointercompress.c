@@ -0,0 +1,192 @@
+/* Wheel rotation and drag motion are only recorded by their handlers. Once no
+ * further pointer event is queued behind them the net result is applied, so a
+ * fast scroll focuses one tab instead of every tab in between. A drag moves an
+ * insertion mark along the bar and reorders the tabs at most dragrate times a
+ * second and when the button is released. */
+static int wheeldelta;
+#if DRAG_PATCH
+static void dragtimeout(void) { dragapply(); }
+static Timer dragtimer = { .func = dragtimeout };
+static long long lastdrag;
+static int dragx = -1, dragy, markpos = -1;
+static Bool dragmoved;
+
+void
+buttonrelease(const XEvent *e)
+{
+	if (e->xbutton.button != Button1 || dragx < 0)
+		return;
+	stoptimer(&dragtimer);
+	dragapply();
+	dragx = -1;
+}
+
+void
+dragapply(void)
+{
+	int t;
+	Arg arg;
+
+	dragmark(-1);
+	lastdrag = msnow();
+	if ((t = dragtarget(dragx, dragy)) < 0 || t == sel)
+		return;
+	arg.i = t - sel;
+	movetab(&arg);
+}
+
+/* Marks where the selected tab would be dropped, directly on the window. The
+ * bar pixmap still holds the undecorated bar to erase the mark with. */
+void
+dragmark(int t)
+{
+	#if SIDEBAR_PATCH
+	/* between two rows of the sidebar */
+	int pos = -1;
+
+	if (t > sel)
+		pos = sidebary(t) + dc.h - 2;
+	else if (t > -1 && t < sel)
+		pos = sidebary(t);
+	if (pos == markpos)
+		return;
+	if (markpos > -1)
+		XCopyArea(dpy, dc.drawable, win, dc.gc, sidebarx(), markpos,
+		          sidebarwidth, 2, sidebarx(), markpos);
+	if ((markpos = pos) > -1) {
+		XSetForeground(dpy, dc.gc, dc.sel[ColFG].pixel);
+		XFillRectangle(dpy, win, dc.gc, sidebarx(), markpos, sidebarwidth, 2);
+	}
+	#else
+	#if BOTTOM_TABS_PATCH
+	int by = wh - bh;
+	#else
+	int by = 0;
+	#endif // BOTTOM_TABS_PATCH
+	int fc, pos = -1;
+
+	if (t > sel) {
+		pos = clients[t]->tabx - 2;
+	} else if (t > -1 && t < sel) {
+		#if LAYOUTCACHE_PATCH
+		fc = getlayout()->fc;
+		#else
+		fc = getfirsttab();
+		#endif // LAYOUTCACHE_PATCH
+		pos = t > fc ? clients[t - 1]->tabx : fc > 0 ? TEXTW(before) : 0;
+	}
+	if (pos == markpos)
+		return;
+	if (markpos > -1)
+		XCopyArea(dpy, dc.drawable, win, dc.gc, markpos, 0, 2, bh, markpos, by);
+	if ((markpos = pos) > -1) {
+		XSetForeground(dpy, dc.gc, dc.sel[ColFG].pixel);
+		XFillRectangle(dpy, win, dc.gc, markpos, by, 2, bh);
+	}
+	#endif // SIDEBAR_PATCH
+}
+
+void
+dragmotion(int x, int y)
+{
+	if (sel < 0)
+		return;
+	dragx = x;
+	dragy = y;
+	dragmoved = True;
+}
+
+int
+dragtarget(int x, int y)
+{
+	#if SIDEBAR_PATCH
+	return sel < 0 ? -1 : sidebarhit(x, y);
+	#elif LAYOUTCACHE_PATCH
+	return sel < 0 ? -1 : layouthit(x);
+	#else
+	int i, fc;
+
+	if (sel < 0 || x < 0 || ((fc = getfirsttab()) > 0 && x < TEXTW(before)))
+		return -1;
+	for (i = fc; i < nclients; i++)
+		if (clients[i]->tabx > x)
+			return i;
+	return -1;
+	#endif // LAYOUTCACHE_PATCH
+}
+#endif // DRAG_PATCH
+
+Bool
+ispointerevent(const XEvent *ev)
+{
+	switch (ev->type) {
+	case MotionNotify:
+		return True;
+	case ButtonPress:
+	case ButtonRelease:
+		return ev->xbutton.button == Button4 || ev->xbutton.button == Button5;
+	}
+	return False;
+}
+
+void
+pointerflush(void)
+{
+	Arg arg;
+	#if DRAG_PATCH
+	long long wait;
+	int t;
+	#endif // DRAG_PATCH
+
+	if (wheeldelta) {
+		arg.i = wheeldelta;
+		wheeldelta = 0;
+		rotate(&arg);
+	}
+	#if DRAG_PATCH
+	if (!dragmoved)
+		return;
+	dragmoved = False;
+	if ((t = dragtarget(dragx, dragy)) < 0 || t == sel) {
+		stoptimer(&dragtimer);
+		dragmark(-1);
+		return;
+	}
+	dragmark(t);
+	if (dragrate <= 0 || dragtimer.expires)
+		return;
+	if ((wait = lastdrag + 1000 / dragrate - msnow()) > 0)
+		settimer(&dragtimer, wait);
+	else
+		dragapply();
+	#endif // DRAG_PATCH
+}
+
+/* Called after every handled event. */
+void
+pointersettle(void)
+{
+	#if EVENTPRIORITY_PATCH
+	EventQueue *q = &evqueues[EvInput];
+	#else
+	XEvent next;
+	#endif // EVENTPRIORITY_PATCH
+
+	#if DRAG_PATCH
+	if (!wheeldelta && !dragmoved)
+	#else
+	if (!wheeldelta)
+	#endif // DRAG_PATCH
+		return;
+	#if EVENTPRIORITY_PATCH
+	if (q->n && ispointerevent(&q->ev[q->head].ev))
+		return;
+	#else
+	if (XEventsQueued(dpy, QueuedAfterReading)) {
+		XPeekEvent(dpy, &next);
+		if (ispointerevent(&next))
+			return;
+	}
+	#endif // EVENTPRIORITY_PATCH
+	pointerflush();
+}
@@ -0,0 +1,10 @@
+#if DRAG_PATCH
+static void buttonrelease(const XEvent *e);
+static void dragapply(void);
+static void dragmark(int t);
+static void dragmotion(int x, int y);
+static int dragtarget(int x, int y);
+#endif // DRAG_PATCH
+static Bool ispointerevent(const XEvent *ev);
+static void pointerflush(void);
+static void pointersettle(void);
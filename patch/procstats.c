@@ -0,0 +1,254 @@
+/* Every tab is mapped to a process tree, rooted at its _NET_WM_PID or else at
+ * the command tabbed spawned for it, and all trees are sampled in one pass on
+ * a timer. The stat, statm and children files of every process stay open
+ * between passes and are read with pread(), so a pass costs three reads per
+ * process and no path lookups. A process in the trees of several tabs, like
+ * that of tabs sharing a _NET_WM_PID, is sampled once and counted for each. */
+static Timer proctimer = { .func = procsample };
+static Proc *procs;
+static int nprocs;
+static unsigned long procpass, proctrees;
+static long long proclast;
+static long hz, pagekb;
+static pid_t spawned[16]; /* spawned commands that no tab claimed yet */
+static int nspawned;
+
+int
+drawstats(XftColor col[ColLast])
+{
+	int h = dc.font.ascent + dc.font.descent, len, w, x, y;
+	#if !RASTER_PATCH
+	XftDraw *d;
+	#endif // !RASTER_PATCH
+
+	len = strlen(dc.stats);
+	w = textnw(dc.stats, len);
+	if (w + 2 * h > dc.w)
+		return 0;
+	x = dc.x + dc.w - w - h / 2;
+	y = dc.y + (dc.h / 2) - (h / 2) + dc.font.ascent;
+	#if RASTER_PATCH
+	render->text(x, y, &col[ColFG], dc.stats, len);
+	#else
+	#if ALPHA_PATCH
+	d = XftDrawCreate(dpy, dc.drawable, visual, cmap);
+	#else
+	d = XftDrawCreate(dpy, dc.drawable, DefaultVisual(dpy, screen), DefaultColormap(dpy, screen));
+	#endif // ALPHA_PATCH
+	XftDrawStringUtf8(d, &col[ColFG], dc.font.xfont, x, y, (XftChar8 *) dc.stats, len);
+	XftDrawDestroy(d);
+	#endif // RASTER_PATCH
+
+	return w + h / 2;
+}
+
+void
+focusbusy(const Arg *arg)
+{
+	int c, busy = -1;
+
+	for (c = 0; c < nclients; c++) {
+		if (busy < 0 || clients[c]->cpu > clients[busy]->cpu
+		    || (clients[c]->cpu == clients[busy]->cpu
+		        && clients[c]->rss > clients[busy]->rss))
+			busy = c;
+	}
+	if (busy > -1)
+		focus(busy);
+}
+
+/* A tab without _NET_WM_PID is taken to be the oldest command spawned for a
+ * new tab that is still running and not claimed by another tab. */
+void
+procclaim(int c)
+{
+	Client *cl = clients[c];
+
+	if (!clientpid(c)) {
+		while (nspawned && !cl->spawnpid) {
+			if (kill(spawned[0], 0) == 0)
+				cl->spawnpid = spawned[0];
+			memmove(spawned, &spawned[1], sizeof(pid_t) * --nspawned);
+		}
+	}
+	if (!proctimer.expires)
+		settimer(&proctimer, procrate);
+}
+
+void
+procclose(Proc *p)
+{
+	if (p->stat >= 0)
+		close(p->stat);
+	if (p->statm >= 0)
+		close(p->statm);
+	if (p->children >= 0)
+		close(p->children);
+}
+
+/* Finds the entry of pid in the table sorted by pid, opening its files if it
+ * was not seen before. */
+Proc *
+procget(pid_t pid)
+{
+	char path[64];
+	Proc *p;
+	int lo = 0, hi = nprocs;
+
+	while (lo < hi) {
+		if (procs[(lo + hi) / 2].pid < pid)
+			lo = (lo + hi) / 2 + 1;
+		else
+			hi = (lo + hi) / 2;
+	}
+	if (lo < nprocs && procs[lo].pid == pid)
+		return &procs[lo];
+	if (nprocs == PROCMAX)
+		return NULL;
+
+	if (!procs)
+		procs = ecalloc(PROCMAX, sizeof(Proc));
+	memmove(&procs[lo + 1], &procs[lo], sizeof(Proc) * (nprocs++ - lo));
+	p = &procs[lo];
+	memset(p, 0, sizeof(Proc));
+	p->pid = pid;
+	snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+	p->stat = open(path, O_RDONLY | O_CLOEXEC);
+	snprintf(path, sizeof(path), "/proc/%d/statm", (int)pid);
+	p->statm = open(path, O_RDONLY | O_CLOEXEC);
+	snprintf(path, sizeof(path), "/proc/%d/task/%d/children", (int)pid, (int)pid);
+	p->children = open(path, O_RDONLY | O_CLOEXEC);
+
+	return p;
+}
+
+ssize_t
+procread(int fd, char *buf, size_t size)
+{
+	ssize_t n = fd < 0 ? -1 : pread(fd, buf, size - 1, 0);
+
+	buf[MAX(n, 0)] = '\0';
+	return n;
+}
+
+void
+procsample(void)
+{
+	unsigned long long ticks;
+	unsigned long rss, cpu;
+	long long now = msnow();
+	char usage[sizeof(clients[0]->usage)];
+	Bool changed = False;
+	Client *cl;
+	pid_t root;
+	int c, i;
+
+	if (!hz) {
+		hz = sysconf(_SC_CLK_TCK);
+		pagekb = sysconf(_SC_PAGESIZE) / 1024;
+	}
+	procpass++;
+
+	for (c = 0; c < nclients; c++) {
+		cl = clients[c];
+		ticks = rss = 0;
+		root = proctree(c, &ticks, &rss);
+		cpu = proclast && now > proclast ? ticks * 100000 / (hz * (now - proclast)) : 0;
+		cl->cpu = cpu;
+		cl->rss = rss;
+
+		if (!root)
+			usage[0] = '\0';
+		else if (rss < 1024)
+			snprintf(usage, sizeof(usage), "%lu%% %luK", cpu, rss);
+		else if (rss < 1024 * 1024)
+			snprintf(usage, sizeof(usage), "%lu%% %luM", cpu, rss / 1024);
+		else
+			snprintf(usage, sizeof(usage), "%lu%% %.1fG", cpu, rss / 1048576.0);
+		if (strcmp(usage, cl->usage)) {
+			memcpy(cl->usage, usage, sizeof(usage));
+			changed = True;
+		}
+	}
+	proclast = now;
+
+	/* forget the processes that are gone or left every tree */
+	for (c = i = 0; i < nprocs; i++) {
+		if (procs[i].seen == procpass)
+			procs[c++] = procs[i];
+		else
+			procclose(&procs[i]);
+	}
+	nprocs = c;
+
+	if (changed)
+		drawbar();
+	if (nclients)
+		settimer(&proctimer, procrate);
+}
+
+void
+procspawned(pid_t pid)
+{
+	if (nspawned == LENGTH(spawned))
+		memmove(spawned, &spawned[1], sizeof(pid_t) * --nspawned);
+	spawned[nspawned++] = pid;
+}
+
+/* Adds the cpu ticks used since the last pass and the resident set size in
+ * kB of the process tree of tab c, returns the root of the tree or 0. */
+pid_t
+proctree(int c, unsigned long long *ticks, unsigned long *rss)
+{
+	static pid_t *stack;
+	static int stacksize;
+	unsigned long long ut, st;
+	unsigned long pages;
+	char buf[4096], *s, *e;
+	pid_t pid, root;
+	Proc *p;
+	int i, n = 0;
+
+	if (!(root = clientpid(c) ? clientpid(c) : clients[c]->spawnpid))
+		return 0;
+	if (!stack)
+		stack = ecalloc((stacksize = 64), sizeof(pid_t));
+	stack[n++] = root;
+	proctrees++;
+
+	while (n) {
+		if (!(p = procget(stack[--n])) || p->tree == proctrees)
+			continue;
+
+		if (p->seen != procpass) {
+			/* utime and stime are the 14th and 15th field, the 2nd may hold spaces */
+			if (procread(p->stat, buf, sizeof(buf)) <= 0 || !(s = strrchr(buf, ')')))
+				continue;
+			p->seen = procpass;
+			p->used = p->rss = 0;
+			for (i = 2; i < 14 && (s = strchr(s + 1, ' ')); i++);
+			if (s && sscanf(s, "%llu %llu", &ut, &st) == 2) {
+				if (p->sampled)
+					p->used = ut + st - MIN(p->ticks, ut + st);
+				p->ticks = ut + st;
+				p->sampled = True;
+			}
+			if (procread(p->statm, buf, sizeof(buf)) > 0
+			    && sscanf(buf, "%*u %lu", &pages) == 1)
+				p->rss = pages * pagekb;
+		}
+		p->tree = proctrees;
+		*ticks += p->used;
+		*rss += p->rss;
+
+		if (procread(p->children, buf, sizeof(buf)) <= 0)
+			continue;
+		for (s = buf; (pid = strtol(s, &e, 10)) > 0; s = e) {
+			if (n == stacksize)
+				stack = erealloc(stack, sizeof(pid_t) * (stacksize *= 2));
+			stack[n++] = pid;
+		}
+	}
+
+	return root;
+}
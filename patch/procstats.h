@@ -0,0 +1,24 @@
+#include <fcntl.h>
+
+#define PROCMAX 256 /* processes sampled at most, each keeps three files open */
+
+typedef struct {
+	pid_t pid;
+	int stat, statm, children;  /* open files in /proc, -1 if missing */
+	Bool sampled;
+	unsigned long long ticks;   /* utime + stime at the last sample */
+	unsigned long long used;    /* ticks used since the pass before */
+	unsigned long rss;          /* resident set size in kB */
+	unsigned long seen;         /* last pass that sampled the process */
+	unsigned long tree;         /* last tree that counted the process */
+} Proc;
+
+static int drawstats(XftColor col[ColLast]);
+static void focusbusy(const Arg *arg);
+static void procclaim(int c);
+static void procclose(Proc *p);
+static Proc *procget(pid_t pid);
+static ssize_t procread(int fd, char *buf, size_t size);
+static void procsample(void);
+static void procspawned(pid_t pid);
+static pid_t proctree(int c, unsigned long long *ticks, unsigned long *rss);
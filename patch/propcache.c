@@ -0,0 +1,121 @@
+/* WM_PROTOCOLS, WM_HINTS, WM_CLASS and _NET_WM_PID are read when a client is
+ * embedded and then served from the cache until a PropertyNotify for that
+ * property comes in. The same goes for the WM_HINTS of tabbed itself, the
+ * window manager clears the urgency hint there. Hints that tabbed sets are
+ * written through. */
+static HintsCache winhints;
+
+const char *
+clientclass(int c)
+{
+	Client *cl = clients[c];
+	XClassHint ch = { NULL, NULL };
+
+	if (!(cl->propvalid & PropClass)) {
+		cl->propvalid |= PropClass;
+		cl->class[0] = cl->instance[0] = '\0';
+		if (XGetClassHint(dpy, cl->win, &ch)) {
+			snprintf(cl->class, sizeof(cl->class), "%s", ch.res_class ? ch.res_class : "");
+			snprintf(cl->instance, sizeof(cl->instance), "%s", ch.res_name ? ch.res_name : "");
+			XFree(ch.res_class);
+			XFree(ch.res_name);
+		}
+	}
+
+	return cl->class;
+}
+
+pid_t
+clientpid(int c)
+{
+	Client *cl = clients[c];
+	Atom type;
+	int format;
+	unsigned long nitems, nleft;
+	unsigned char *data = NULL;
+
+	if (!(cl->propvalid & PropPid)) {
+		cl->propvalid |= PropPid;
+		cl->pid = 0;
+		if (XGetWindowProperty(dpy, cl->win, wmatom[WMPid], 0, 1, False, XA_CARDINAL,
+		                       &type, &format, &nitems, &nleft, &data) == Success
+		    && type == XA_CARDINAL && format == 32 && nitems == 1)
+			cl->pid = *(unsigned long *)data;
+		XFree(data);
+	}
+
+	return cl->pid;
+}
+
+/* Like XGetWMHints() for client c, or for tabbed itself if c < 0, but served
+ * from the cache. Free the result with XFree(). */
+XWMHints *
+gethints(int c)
+{
+	HintsCache *hc = hintscache(c);
+	XWMHints *wmh;
+
+	if (!hc->valid) {
+		hc->valid = True;
+		if ((hc->set = (wmh = XGetWMHints(dpy, c < 0 ? win : clients[c]->win)) != NULL)) {
+			hc->hints = *wmh;
+			XFree(wmh);
+		}
+	}
+	if (!hc->set || !(wmh = XAllocWMHints()))
+		return NULL;
+	*wmh = hc->hints;
+
+	return wmh;
+}
+
+HintsCache *
+hintscache(int c)
+{
+	return c < 0 ? &winhints : &clients[c]->hints;
+}
+
+void
+propfetch(int c)
+{
+	XWMHints *wmh;
+
+	isprotodel(c);
+	if ((wmh = gethints(c)))
+		XFree(wmh);
+	clientclass(c);
+	clientpid(c);
+}
+
+void
+propinvalidate(const XPropertyEvent *ev)
+{
+	Client *cl;
+	int c;
+
+	if (ev->window == win && ev->atom == XA_WM_HINTS)
+		winhints.valid = False;
+	if ((c = getclient(ev->window)) < 0)
+		return;
+
+	cl = clients[c];
+	if (ev->atom == wmatom[WMProtocols])
+		cl->protoknown = False;
+	else if (ev->atom == XA_WM_HINTS)
+		cl->hints.valid = False;
+	else if (ev->atom == XA_WM_CLASS)
+		cl->propvalid &= ~PropClass;
+	else if (ev->atom == wmatom[WMPid])
+		cl->propvalid &= ~PropPid;
+}
+
+/* XSetWMHints() that keeps the cache up to date. */
+void
+sethints(int c, XWMHints *wmh)
+{
+	HintsCache *hc = hintscache(c);
+
+	XSetWMHints(dpy, c < 0 ? win : clients[c]->win, wmh);
+	hc->valid = hc->set = True;
+	hc->hints = *wmh;
+}
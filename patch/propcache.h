@@ -0,0 +1,9 @@
+enum { PropClass = 1, PropPid = 2 }; /* Client propvalid bits */
+
+static const char *clientclass(int c);
+static pid_t clientpid(int c);
+static XWMHints *gethints(int c);
+static HintsCache *hintscache(int c);
+static void propfetch(int c);
+static void propinvalidate(const XPropertyEvent *ev);
+static void sethints(int c, XWMHints *wmh);
@@ -0,0 +1,428 @@
+/* The bar is drawn through a small backend interface. The core backend issues
+ * the usual fill and Xft requests, one per rectangle and string. The raster
+ * backend draws into a client side image instead: fills and cached glyph
+ * coverage masks are composited with SSE2 / AVX2 and the whole bar is uploaded
+ * with a single XShmPutImage, or XPutImage if the server is not local. */
+static const Renderer corerenderer = {
+	xfill, xtext, xtextw,
+	#if TABICONS_PATCH
+	compositeicon,
+	#endif // TABICONS_PATCH
+	xflush,
+};
+static const Renderer rasterrenderer = {
+	rasterfill, rastertext, rastertextw,
+	#if TABICONS_PATCH
+	rastericon,
+	#endif // TABICONS_PATCH
+	rasterflush,
+};
+static const Renderer *render = &corerenderer;
+
+static XImage *rimg;
+static XShmSegmentInfo shminfo;
+static Bool useshm;
+static Visual *rvisual;
+static int rdepth;
+static RGlyph *glyphs;
+static int nglyphs, glyphcap;
+#if TABICONS_PATCH
+static struct {
+	Picture icon;
+	int x, y, s;
+} *ricons;
+static int nricons, riconcap;
+#endif // TABICONS_PATCH
+
+#if defined(__SSE2__)
+/* dst = (fg * a + dst * (255 - a)) / 255 for four pixels */
+static inline __m128i
+blend4(__m128i dst, __m128i fg16, uint32_t a4)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i half = _mm_set1_epi16(128);
+	const __m128i max = _mm_set1_epi16(255);
+	__m128i a, alo, ahi, lo, hi;
+
+	a = _mm_unpacklo_epi8(_mm_cvtsi32_si128(a4), zero);
+	a = _mm_unpacklo_epi16(a, a);
+	alo = _mm_unpacklo_epi32(a, a);
+	ahi = _mm_unpackhi_epi32(a, a);
+	lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(fg16, alo),
+	     _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(max, alo))), half);
+	hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(fg16, ahi),
+	     _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(max, ahi))), half);
+	lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+	hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+	return _mm_packus_epi16(lo, hi);
+}
+#endif // __SSE2__
+
+void
+blendrow(uint32_t *dst, const unsigned char *mask, uint32_t fg, int n)
+{
+	int i = 0;
+	uint32_t a, d;
+	#if defined(__SSE2__)
+	const __m128i fg16 = _mm_unpacklo_epi8(_mm_set1_epi32(fg), _mm_setzero_si128());
+	uint32_t a4;
+
+	for (; i + 4 <= n; i += 4) {
+		memcpy(&a4, &mask[i], 4);
+		if (!a4)
+			continue;
+		if (a4 == 0xffffffff) {
+			_mm_storeu_si128((__m128i *)&dst[i], _mm_set1_epi32(fg));
+			continue;
+		}
+		_mm_storeu_si128((__m128i *)&dst[i],
+		                 blend4(_mm_loadu_si128((__m128i *)&dst[i]), fg16, a4));
+	}
+	#endif // __SSE2__
+
+	for (; i < n; i++) {
+		if (!(a = mask[i]))
+			continue;
+		d = dst[i];
+		#define BLEND(s) ((((fg >> s & 0xff) * a + (d >> s & 0xff) * (255 - a) + 128) \
+		                 + (((fg >> s & 0xff) * a + (d >> s & 0xff) * (255 - a) + 128) >> 8)) >> 8)
+		dst[i] = BLEND(24) << 24 | BLEND(16) << 16 | BLEND(8) << 8 | BLEND(0);
+		#undef BLEND
+	}
+}
+
+void
+fillrow(uint32_t *dst, uint32_t px, int n)
+{
+	int i = 0;
+
+	#if defined(__AVX2__)
+	const __m256i v8 = _mm256_set1_epi32(px);
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_si256((__m256i *)&dst[i], v8);
+	#endif // __AVX2__
+	#if defined(__SSE2__)
+	const __m128i v4 = _mm_set1_epi32(px);
+	for (; i + 4 <= n; i += 4)
+		_mm_storeu_si128((__m128i *)&dst[i], v4);
+	#endif // __SSE2__
+	for (; i < n; i++)
+		dst[i] = px;
+}
+
+RGlyph *
+getglyph(FT_Face face, FcChar32 ucs)
+{
+	FT_Bitmap *bm;
+	RGlyph *g, *old;
+	int i, x, y, oldcap;
+
+	if (nglyphs * 2 >= glyphcap) {
+		old = glyphs;
+		oldcap = glyphcap;
+		glyphcap = glyphcap ? glyphcap * 2 : 256;
+		glyphs = ecalloc(glyphcap, sizeof(*glyphs));
+		nglyphs = 0;
+		for (i = 0; i < oldcap; i++) {
+			if (!old[i].used)
+				continue;
+			for (g = &glyphs[old[i].ucs & (glyphcap - 1)]; g->used;
+			     g = g == &glyphs[glyphcap - 1] ? glyphs : g + 1);
+			*g = old[i];
+			nglyphs++;
+		}
+		free(old);
+	}
+
+	for (g = &glyphs[ucs & (glyphcap - 1)]; g->used;
+	     g = g == &glyphs[glyphcap - 1] ? glyphs : g + 1)
+		if (g->ucs == ucs)
+			return g;
+
+	g->used = True;
+	g->ucs = ucs;
+	nglyphs++;
+	if (FT_Load_Glyph(face, XftCharIndex(dpy, dc.font.xfont, ucs),
+	                  rasterloadflags() | FT_LOAD_RENDER))
+		return g;
+
+	bm = &face->glyph->bitmap;
+	g->adv = (face->glyph->advance.x + 32) >> 6;
+	g->x = face->glyph->bitmap_left;
+	g->y = -face->glyph->bitmap_top;
+	if (bm->pixel_mode != FT_PIXEL_MODE_GRAY && bm->pixel_mode != FT_PIXEL_MODE_MONO)
+		return g; /* colour bitmaps are not supported, only advance */
+	g->w = bm->width;
+	g->h = bm->rows;
+	g->mask = ecalloc(MAX(1, g->w * g->h), 1);
+	for (y = 0; y < g->h; y++) {
+		for (x = 0; x < g->w; x++) {
+			if (bm->pixel_mode == FT_PIXEL_MODE_GRAY)
+				g->mask[y * g->w + x] = bm->buffer[y * bm->pitch + x];
+			else
+				g->mask[y * g->w + x] =
+					bm->buffer[y * bm->pitch + x / 8] & (0x80 >> (x % 8)) ? 255 : 0;
+		}
+	}
+
+	return g;
+}
+
+void
+rasterfill(int x, int y, int w, int h, const XftColor *col)
+{
+	XImage *img = rasterimage();
+	int i;
+
+	x = MAX(x, 0);
+	y = MAX(y, 0);
+	w = MIN(w, img->width - x);
+	h = MIN(h, img->height - y);
+	for (i = 0; w > 0 && i < h; i++)
+		fillrow((uint32_t *)(img->data + (y + i) * img->bytes_per_line) + x,
+		        col->pixel, w);
+}
+
+void
+rasterflush(int y, int h)
+{
+	XImage *img = rasterimage();
+	#if TABICONS_PATCH
+	int i;
+	#endif // TABICONS_PATCH
+
+	h = MIN(h, img->height);
+	if (useshm)
+		XShmPutImage(dpy, dc.drawable, dc.gc, img, 0, 0, 0, 0, img->width, h, False);
+	else
+		XPutImage(dpy, dc.drawable, dc.gc, img, 0, 0, 0, 0, img->width, h);
+	#if TABICONS_PATCH
+	/* icons stay server side pictures, composite them over the upload */
+	for (i = 0; i < nricons; i++)
+		compositeicon(ricons[i].icon, ricons[i].x, ricons[i].y, ricons[i].s);
+	nricons = 0;
+	#endif // TABICONS_PATCH
+	/* drawbar() syncs afterwards, so the shared image is not touched before
+	 * the server has read it */
+	XCopyArea(dpy, dc.drawable, win, dc.gc, 0, 0, ww, h, 0, y);
+}
+
+void
+rasterfree(void)
+{
+	if (!rimg)
+		return;
+	if (useshm) {
+		XShmDetach(dpy, &shminfo);
+		XSync(dpy, False);
+		XDestroyImage(rimg);
+		shmdt(shminfo.shmaddr);
+	} else {
+		XDestroyImage(rimg);
+	}
+	rimg = NULL;
+}
+
+void
+rasterfreeglyphs(void)
+{
+	int i;
+
+	for (i = 0; i < glyphcap; i++)
+		free(glyphs[i].mask);
+	free(glyphs);
+	glyphs = NULL;
+	nglyphs = glyphcap = 0;
+}
+
+#if TABICONS_PATCH
+void
+rastericon(Picture icon, int x, int y, int s)
+{
+	if (nricons == riconcap) {
+		riconcap = riconcap ? riconcap * 2 : 16;
+		ricons = erealloc(ricons, riconcap * sizeof(*ricons));
+	}
+	ricons[nricons].icon = icon;
+	ricons[nricons].x = x;
+	ricons[nricons].y = y;
+	ricons[nricons++].s = s;
+}
+#endif // TABICONS_PATCH
+
+XImage *
+rasterimage(void)
+{
+	if (rimg && rimg->width == ww && rimg->height == dc.h)
+		return rimg;
+
+	rasterfree();
+	if (useshm) {
+		rimg = XShmCreateImage(dpy, rvisual, rdepth, ZPixmap, NULL, &shminfo, ww, dc.h);
+		if (rimg && (shminfo.shmid = shmget(IPC_PRIVATE, rimg->bytes_per_line * rimg->height,
+		                                    IPC_CREAT | 0600)) != -1) {
+			shminfo.shmaddr = rimg->data = shmat(shminfo.shmid, NULL, 0);
+			shminfo.readOnly = False;
+			if (shminfo.shmaddr != (void *)-1 && XShmAttach(dpy, &shminfo)) {
+				XSync(dpy, False);
+				/* freed once both sides have detached */
+				shmctl(shminfo.shmid, IPC_RMID, NULL);
+				return rimg;
+			}
+			if (shminfo.shmaddr != (void *)-1)
+				shmdt(shminfo.shmaddr);
+			shmctl(shminfo.shmid, IPC_RMID, NULL);
+		}
+		if (rimg)
+			XDestroyImage(rimg);
+		useshm = False;
+	}
+	rimg = XCreateImage(dpy, rvisual, rdepth, ZPixmap, 0,
+	                    ecalloc(dc.h, ww * 4), ww, dc.h, 32, ww * 4);
+
+	return rimg;
+}
+
+void
+rasterinit(void)
+{
+	struct sockaddr_storage addr;
+	socklen_t len = sizeof(addr);
+	int one = 1;
+
+	#if ALPHA_PATCH
+	rvisual = visual;
+	rdepth = 32;
+	#else
+	rvisual = DefaultVisual(dpy, screen);
+	rdepth = DefaultDepth(dpy, screen);
+	#endif // ALPHA_PATCH
+
+	#if SIDEBAR_PATCH
+	/* the image only holds a horizontal bar, the sidebar is drawn row by row */
+	return;
+	#endif // SIDEBAR_PATCH
+	/* pixels are written as native 32-bit xRGB words */
+	if (!rasterbar || (rdepth != 24 && rdepth != 32) || rvisual->red_mask != 0xff0000
+	    || rvisual->green_mask != 0xff00 || rvisual->blue_mask != 0xff
+	    || ImageByteOrder(dpy) != (*(char *)&one ? LSBFirst : MSBFirst))
+		return;
+
+	/* shared memory only works with a server on this machine */
+	useshm = XShmQueryExtension(dpy)
+	         && !getsockname(ConnectionNumber(dpy), (struct sockaddr *)&addr, &len)
+	         && addr.ss_family == AF_UNIX;
+	render = &rasterrenderer;
+}
+
+int
+rasterloadflags(void)
+{
+	FcPattern *p = dc.font.xfont->pattern;
+	FcBool b;
+	int i, flags = FT_LOAD_DEFAULT;
+
+	/* follow the rendering options Xft would use */
+	if (FcPatternGetBool(p, FC_ANTIALIAS, 0, &b) == FcResultMatch && !b)
+		flags |= FT_LOAD_TARGET_MONO;
+	else if (FcPatternGetInteger(p, FC_HINT_STYLE, 0, &i) == FcResultMatch
+	         && i == FC_HINT_SLIGHT)
+		flags |= FT_LOAD_TARGET_LIGHT;
+	if ((FcPatternGetBool(p, FC_HINTING, 0, &b) == FcResultMatch && !b)
+	    || (FcPatternGetInteger(p, FC_HINT_STYLE, 0, &i) == FcResultMatch
+	        && i == FC_HINT_NONE))
+		flags |= FT_LOAD_NO_HINTING;
+	if (FcPatternGetBool(p, FC_AUTOHINT, 0, &b) == FcResultMatch && b)
+		flags |= FT_LOAD_FORCE_AUTOHINT;
+	if (FcPatternGetBool(p, FC_EMBEDDED_BITMAP, 0, &b) == FcResultMatch && !b)
+		flags |= FT_LOAD_NO_BITMAP;
+
+	return flags;
+}
+
+void
+rastertext(int x, int y, const XftColor *col, const char *text, int len)
+{
+	XImage *img = rasterimage();
+	FT_Face face;
+	FcChar32 ucs;
+	RGlyph *g;
+	int n, gx, gy, x0, x1, row;
+
+	if (!(face = XftLockFace(dc.font.xfont)))
+		return;
+	for (; len > 0; text += n, len -= n) {
+		if ((n = FcUtf8ToUcs4((FcChar8 *)text, &ucs, len)) <= 0) {
+			n = 1;
+			continue;
+		}
+		g = getglyph(face, ucs);
+		gx = x + g->x;
+		gy = y + g->y;
+		x0 = MAX(0, -gx);
+		x1 = MIN(g->w, img->width - gx);
+		for (row = MAX(0, -gy); g->mask && x0 < x1 && row < g->h && gy + row < img->height; row++)
+			blendrow((uint32_t *)(img->data + (gy + row) * img->bytes_per_line) + gx + x0,
+			         &g->mask[row * g->w + x0], col->pixel, x1 - x0);
+		x += g->adv;
+	}
+	XftUnlockFace(dc.font.xfont);
+}
+
+int
+rastertextw(const char *text, int len)
+{
+	FT_Face face;
+	FcChar32 ucs;
+	int n, w = 0;
+
+	if (!(face = XftLockFace(dc.font.xfont)))
+		return 0;
+	for (; len > 0; text += n, len -= n) {
+		if ((n = FcUtf8ToUcs4((FcChar8 *)text, &ucs, len)) <= 0)
+			n = 1;
+		else
+			w += getglyph(face, ucs)->adv;
+	}
+	XftUnlockFace(dc.font.xfont);
+
+	return w;
+}
+
+void
+xfill(int x, int y, int w, int h, const XftColor *col)
+{
+	XRectangle r = { x, y, w, h };
+
+	XSetForeground(dpy, dc.gc, col->pixel);
+	XFillRectangles(dpy, dc.drawable, dc.gc, &r, 1);
+}
+
+void
+xflush(int y, int h)
+{
+	XCopyArea(dpy, dc.drawable, win, dc.gc, 0, 0, ww, h, 0, y);
+}
+
+void
+xtext(int x, int y, const XftColor *col, const char *text, int len)
+{
+	XftDraw *d;
+
+	#if ALPHA_PATCH
+	d = XftDrawCreate(dpy, dc.drawable, visual, cmap);
+	#else
+	d = XftDrawCreate(dpy, dc.drawable, DefaultVisual(dpy, screen), DefaultColormap(dpy, screen));
+	#endif // ALPHA_PATCH
+	XftDrawStringUtf8(d, col, dc.font.xfont, x, y, (XftChar8 *) text, len);
+	XftDrawDestroy(d);
+}
+
+int
+xtextw(const char *text, int len)
+{
+	XGlyphInfo ext;
+
+	XftTextExtentsUtf8(dpy, dc.font.xfont, (XftChar8 *) text, len, &ext);
+	return ext.xOff;
+}
@@ -0,0 +1,45 @@
+#include <stdint.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/socket.h>
+#include <X11/extensions/XShm.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif // __SSE2__
+
+typedef struct {
+	void (*fill)(int x, int y, int w, int h, const XftColor *col);
+	void (*text)(int x, int y, const XftColor *col, const char *text, int len);
+	int (*textw)(const char *text, int len);
+	#if TABICONS_PATCH
+	void (*icon)(Picture icon, int x, int y, int s);
+	#endif // TABICONS_PATCH
+	void (*flush)(int y, int h);
+} Renderer; /* bar drawing backend */
+
+typedef struct {
+	Bool used;
+	FcChar32 ucs;
+	short x, y, w, h, adv; /* mask offset from the pen position, size, advance */
+	unsigned char *mask;   /* 8-bit coverage */
+} RGlyph;
+
+static void blendrow(uint32_t *dst, const unsigned char *mask, uint32_t fg, int n);
+static void fillrow(uint32_t *dst, uint32_t px, int n);
+static RGlyph *getglyph(FT_Face face, FcChar32 ucs);
+static void rasterfill(int x, int y, int w, int h, const XftColor *col);
+static void rasterflush(int y, int h);
+static void rasterfree(void);
+static void rasterfreeglyphs(void);
+#if TABICONS_PATCH
+static void rastericon(Picture icon, int x, int y, int s);
+#endif // TABICONS_PATCH
+static XImage *rasterimage(void);
+static void rasterinit(void);
+static int rasterloadflags(void);
+static void rastertext(int x, int y, const XftColor *col, const char *text, int len);
+static int rastertextw(const char *text, int len);
+static void xfill(int x, int y, int w, int h, const XftColor *col);
+static void xflush(int y, int h);
+static void xtext(int x, int y, const XftColor *col, const char *text, int len);
+static int xtextw(const char *text, int len);
@@ -0,0 +1,180 @@
+/* Tabs are listed as rows in a column on the left or right of the window.
+ * Only the rows inside the viewport are drawn, and of those only the ones
+ * whose title, colour or icon differ from what the bar pixmap already holds.
+ * When the viewport scrolls the pixels of the rows that stay visible are
+ * moved with a single copy and only the uncovered rows are drawn. */
+static SideRow *siderows;
+static int nsiderows, sidetop;
+
+void
+drawsidebar(void)
+{
+	int r, c, d, x = sidebarx(), rowh = dc.h, nvis, full, top;
+	int y0 = wh, y1 = 0;
+	SideRow want;
+
+	nvis = (wh + rowh - 1) / rowh;
+	full = MAX(1, wh / rowh);
+	if (nvis != nsiderows) {
+		siderows = erealloc(siderows, sizeof(SideRow) * MAX(nvis, 1));
+		nsiderows = nvis;
+		sidebarreset();
+	}
+
+	/* keep the selected tab in view */
+	top = sidetop;
+	if (sel > -1 && sel < top)
+		top = sel;
+	else if (sel >= top + full)
+		top = sel - full + 1;
+	top = MAX(0, MIN(top, nclients - full));
+
+	if ((d = top - sidetop) && abs(d) < nvis) {
+		if (d > 0) {
+			XCopyArea(dpy, dc.drawable, dc.drawable, dc.gc, x, d * rowh,
+			          sidebarwidth, (nvis - d) * rowh, x, 0);
+			memmove(siderows, &siderows[d], sizeof(SideRow) * (nvis - d));
+			for (r = nvis - d; r < nvis; r++)
+				siderows[r].col = NULL;
+			/* the last row was cut off by the bottom of the window */
+			if (nvis > full)
+				siderows[nvis - 1 - d].col = NULL;
+		} else {
+			XCopyArea(dpy, dc.drawable, dc.drawable, dc.gc, x, 0,
+			          sidebarwidth, (nvis + d) * rowh, x, -d * rowh);
+			memmove(&siderows[-d], siderows, sizeof(SideRow) * (nvis + d));
+			for (r = 0; r < -d; r++)
+				siderows[r].col = NULL;
+		}
+		y0 = 0;
+		y1 = wh;
+	} else if (d) {
+		sidebarreset();
+	}
+	sidetop = top;
+	#if LAZYTITLES_PATCH
+	refreshtitles(top, top + nvis);
+	drawpending = False;
+	#endif // LAZYTITLES_PATCH
+
+	for (r = 0; r < nvis; r++) {
+		c = top + r;
+		want.c = c < nclients ? clients[c] : NULL;
+		want.col = !want.c ? dc.norm : c == sel ? dc.sel :
+		           clients[c]->urgent ? dc.urg : dc.norm;
+		#if TABICONS_PATCH
+		want.icon = want.c ? tabicon(c) : None;
+		#endif // TABICONS_PATCH
+		#if ACTIVITY_PATCH
+		want.activity = want.c && clients[c]->activity;
+		#endif // ACTIVITY_PATCH
+		#if PROCSTATS_PATCH
+		snprintf(want.stats, sizeof(want.stats), "%s", want.c ? clients[c]->usage : "");
+		#endif // PROCSTATS_PATCH
+		#if CLIENTNUMBER_PATCH && BASENAME_PATCH
+		if (want.c)
+			snprintf(want.text, sizeof(want.text), "%d: %s", c + 1,
+			         basenametitles ? clients[c]->basename : clients[c]->name);
+		#elif CLIENTNUMBER_PATCH
+		if (want.c)
+			snprintf(want.text, sizeof(want.text), "%d: %s", c + 1,
+			         clients[c]->name);
+		#elif BASENAME_PATCH
+		if (want.c)
+			snprintf(want.text, sizeof(want.text), "%s",
+			         basenametitles ? clients[c]->basename : clients[c]->name);
+		#else
+		if (want.c)
+			snprintf(want.text, sizeof(want.text), "%s", clients[c]->name);
+		#endif // CLIENTNUMBER_PATCH
+		if (!want.c)
+			want.text[0] = '\0';
+
+		if (siderows[r].col == want.col && siderows[r].c == want.c
+		    #if TABICONS_PATCH
+		    && siderows[r].icon == want.icon
+		    #endif // TABICONS_PATCH
+		    #if ACTIVITY_PATCH
+		    && siderows[r].activity == want.activity
+		    #endif // ACTIVITY_PATCH
+		    #if PROCSTATS_PATCH
+		    && !strcmp(siderows[r].stats, want.stats)
+		    #endif // PROCSTATS_PATCH
+		    && !strcmp(siderows[r].text, want.text))
+			continue;
+
+		dc.x = x;
+		dc.y = r * rowh;
+		dc.w = sidebarwidth;
+		#if TABICONS_PATCH
+		dc.icon = want.icon;
+		#endif // TABICONS_PATCH
+		#if ACTIVITY_PATCH
+		dc.activity = want.activity;
+		#endif // ACTIVITY_PATCH
+		#if PROCSTATS_PATCH
+		dc.stats = want.stats;
+		#endif // PROCSTATS_PATCH
+		#if FONTFALLBACK_PATCH
+		dc.runs = want.c ? &clients[c]->runs : NULL;
+		#endif // FONTFALLBACK_PATCH
+		drawtext(want.c ? want.text : NULL, want.col);
+		#if TABICONS_PATCH
+		dc.icon = None;
+		#endif // TABICONS_PATCH
+		#if ACTIVITY_PATCH
+		dc.activity = False;
+		#endif // ACTIVITY_PATCH
+		#if PROCSTATS_PATCH
+		dc.stats = NULL;
+		#endif // PROCSTATS_PATCH
+		#if FONTFALLBACK_PATCH
+		dc.runs = NULL;
+		#endif // FONTFALLBACK_PATCH
+		siderows[r] = want;
+		y0 = MIN(y0, dc.y);
+		y1 = MAX(y1, dc.y + rowh);
+	}
+	dc.y = 0;
+
+	if (y0 < y1)
+		XCopyArea(dpy, dc.drawable, win, dc.gc, x, y0, sidebarwidth, y1 - y0, x, y0);
+	XSync(dpy, False);
+}
+
+/* Returns the tab in the row at x, y or -1. */
+int
+sidebarhit(int x, int y)
+{
+	int c;
+
+	if (x < sidebarx() || x >= sidebarx() + sidebarwidth || y < 0)
+		return -1;
+	c = sidetop + y / dc.h;
+	return c < nclients ? c : -1;
+}
+
+/* Forgets what the bar pixmap holds, so every visible row is drawn again. */
+void
+sidebarreset(void)
+{
+	int r;
+
+	for (r = 0; r < nsiderows; r++)
+		siderows[r].col = NULL;
+}
+
+int
+sidebarx(void)
+{
+	return sidebarright ? ww - sidebarwidth : 0;
+}
+
+#if LAZYTITLES_PATCH || (DRAG_PATCH && POINTERCOMPRESS_PATCH)
+/* Returns the top of the row of tab c, relative to the viewport. */
+int
+sidebary(int c)
+{
+	return (c - sidetop) * dc.h;
+}
+#endif // LAZYTITLES_PATCH | (DRAG_PATCH && POINTERCOMPRESS_PATCH)
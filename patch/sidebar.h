@@ -0,0 +1,22 @@
+typedef struct {
+	Client *c;      /* NULL for a row below the last tab */
+	XftColor *col;  /* NULL when the row has to be drawn */
+	#if TABICONS_PATCH
+	Picture icon;
+	#endif // TABICONS_PATCH
+	#if ACTIVITY_PATCH
+	Bool activity;
+	#endif // ACTIVITY_PATCH
+	#if PROCSTATS_PATCH
+	char stats[24];
+	#endif // PROCSTATS_PATCH
+	char text[312];
+} SideRow;
+
+static void drawsidebar(void);
+static int sidebarhit(int x, int y);
+static void sidebarreset(void);
+static int sidebarx(void);
+#if LAZYTITLES_PATCH || (DRAG_PATCH && POINTERCOMPRESS_PATCH)
+static int sidebary(int c);
+#endif // LAZYTITLES_PATCH | (DRAG_PATCH && POINTERCOMPRESS_PATCH)
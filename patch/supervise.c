@@ -0,0 +1,190 @@
+/* Every command spawned is watched through a pidfd served by the main loop,
+ * so tabbed reaps it itself and learns how it exited. Commands spawned for a
+ * new tab are tied to the next tab that maps, which tells a command that died
+ * before mapping a window from one that keeps running after its window went
+ * away. Crashed tabs can be spawned again with an exponential backoff.
+ * Commands that could not get a pidfd are polled with waitpid() instead. */
+static Child *kids;
+static int nkids, nextrestarts;
+static pid_t *strays;
+static int nstrays;
+static Timer supervisetimer = { .func = supervisetick };
+
+void
+childexited(int fd, short revents)
+{
+	char status[64];
+	siginfo_t si = { 0 };
+	Child *k;
+	Bool crashed;
+	long long now = msnow();
+
+	if (!(k = getchild(0, fd, None)))
+		return;
+	delwatch(fd);
+	if (syscall(SYS_waitid, P_PIDFD, fd, &si, WEXITED, NULL) < 0)
+		si.si_code = 0;
+	close(fd);
+	k->fd = -1;
+
+	crashed = si.si_code == CLD_KILLED || si.si_code == CLD_DUMPED
+	          || (si.si_code == CLD_EXITED && si.si_status != 0);
+	if (si.si_code == CLD_EXITED)
+		snprintf(status, sizeof(status), "exited with status %d", si.si_status);
+	else if (si.si_code == CLD_KILLED || si.si_code == CLD_DUMPED)
+		snprintf(status, sizeof(status), "was killed by signal %d", si.si_status);
+	else
+		snprintf(status, sizeof(status), "exited");
+
+	if (k->tab && !k->win)
+		fprintf(stderr, "%s: tab command %d %s before mapping a window\n",
+		        argv0, (int)k->pid, status);
+	else if (k->tab && crashed)
+		fprintf(stderr, "%s: tab command %d %s\n", argv0, (int)k->pid, status);
+
+	/* a command that never got to map a window would leave -f empty */
+	if (k->tab && !k->killed
+	    && ((restartcrashed && crashed) || (fillagain && !k->win && !nclients))) {
+		if (now - k->started > STABLETIME)
+			k->restarts = 0;
+		k->due = now + ((long long)restartdelay << MIN(k->restarts, 6));
+		if (!supervisetimer.expires || supervisetimer.expires > k->due)
+			settimer(&supervisetimer, k->due - now);
+		return;
+	}
+
+	memmove(k, k + 1, sizeof(Child) * (--nkids - (k - kids)));
+}
+
+/* Finds the child by pid, by pidfd or by the tab it is tied to. */
+Child *
+getchild(pid_t pid, int fd, Window w)
+{
+	int i;
+
+	for (i = 0; i < nkids; i++) {
+		if ((pid && kids[i].pid == pid) || (fd > 0 && kids[i].fd == fd)
+		    || (w && kids[i].win == w))
+			return &kids[i];
+	}
+
+	return NULL;
+}
+
+void
+supervisegone(Window w)
+{
+	Child *k;
+
+	if (!(k = getchild(0, 0, w)) || k->fd < 0)
+		return;
+	k->gone = True;
+	k->due = msnow() + orphantimeout;
+	if (!supervisetimer.expires || supervisetimer.expires > k->due)
+		settimer(&supervisetimer, orphantimeout);
+}
+
+/* Returns whether children can be watched through pidfds, and reaped by
+ * tabbed instead of the kernel. */
+Bool
+superviseinit(void)
+{
+	int fd;
+
+	if ((fd = syscall(SYS_pidfd_open, getpid(), 0)) < 0)
+		return False;
+	close(fd);
+
+	return True;
+}
+
+void
+supervisespawned(pid_t pid, Bool tab)
+{
+	Child *k;
+	int fd;
+
+	if ((fd = syscall(SYS_pidfd_open, pid, 0)) < 0) {
+		fprintf(stderr, "%s: cannot watch command %d\n", argv0, (int)pid);
+		strays = erealloc(strays, sizeof(pid_t) * (nstrays + 1));
+		strays[nstrays++] = pid;
+		if (!supervisetimer.expires || supervisetimer.expires > msnow() + STRAYPOLL)
+			settimer(&supervisetimer, STRAYPOLL);
+		return;
+	}
+
+	kids = erealloc(kids, sizeof(Child) * (nkids + 1));
+	k = &kids[nkids++];
+	memset(k, 0, sizeof(Child));
+	k->pid = pid;
+	k->fd = fd;
+	k->tab = tab;
+	k->restarts = nextrestarts;
+	k->started = msnow();
+	addwatch(fd, POLLIN, childexited);
+}
+
+/* Ties a newly embedded client to the command spawned for it: the one with
+ * its _NET_WM_PID if known, else the oldest tab command without a tab. */
+void
+supervisetie(int c)
+{
+	Child *k = NULL;
+	int i;
+
+	#if PROPCACHE_PATCH
+	if (clientpid(c) && (k = getchild(clientpid(c), 0, None)) && (!k->tab || k->win))
+		k = NULL;
+	#endif // PROPCACHE_PATCH
+	for (i = 0; !k && i < nkids; i++)
+		if (kids[i].tab && !kids[i].win && kids[i].fd >= 0)
+			k = &kids[i];
+	if (k)
+		k->win = clients[c]->win;
+}
+
+void
+supervisetick(void)
+{
+	long long now = msnow(), next = 0;
+	int i, restarts;
+
+	/* reap the commands that are not watched, they would stay zombies */
+	for (i = 0; i < nstrays; i++)
+		if (waitpid(strays[i], NULL, WNOHANG) != 0)
+			strays[i--] = strays[--nstrays];
+	if (nstrays)
+		next = now + STRAYPOLL;
+
+	for (i = 0; i < nkids; i++) {
+		if (kids[i].fd >= 0 && !kids[i].gone)
+			continue;
+		/* the restart of a crashed tab is due, or its orphan report */
+		if (kids[i].due > now) {
+			next = next ? MIN(next, kids[i].due) : kids[i].due;
+			continue;
+		}
+
+		if (kids[i].fd >= 0) {
+			/* still running long after its window went away */
+			kids[i].gone = False;
+			kids[i].killed = killorphans;
+			fprintf(stderr, "%s: tab command %d outlived its window%s\n", argv0,
+			        (int)kids[i].pid, killorphans ? ", terminating it" : "");
+			if (killorphans)
+				syscall(SYS_pidfd_send_signal, kids[i].fd, SIGTERM, NULL, 0);
+			continue;
+		}
+
+		restarts = kids[i].restarts + 1;
+		memmove(&kids[i], &kids[i + 1], sizeof(Child) * (--nkids - i));
+		i--;
+		if (!running)
+			continue;
+		nextrestarts = restarts;
+		spawn(NULL);
+		nextrestarts = 0;
+	}
+	if (next)
+		settimer(&supervisetimer, next - now);
+}
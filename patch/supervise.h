@@ -0,0 +1,35 @@
+#include <sys/syscall.h>
+
+/* not every libc has wrappers for these yet */
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+#ifndef P_PIDFD
+#define P_PIDFD 3
+#endif
+
+#define STABLETIME 60000 /* ms a restarted tab has to live to reset its backoff */
+#define STRAYPOLL 1000   /* ms between checks of commands that have no pidfd */
+
+typedef struct {
+	pid_t pid;
+	int fd;              /* pidfd, -1 once reaped and waiting to be restarted */
+	Bool tab;            /* spawned for a new tab, not by a key binding */
+	Window win;          /* the tab it was tied to, None before it mapped one */
+	Bool gone;           /* the window of the tab went away */
+	Bool killed;         /* terminated by tabbed, not to be restarted */
+	int restarts;        /* crashes in a row that were restarted */
+	long long started;
+	long long due;       /* when to report it as orphaned, or to restart it */
+} Child;
+
+static void childexited(int fd, short revents);
+static Child *getchild(pid_t pid, int fd, Window w);
+static void supervisegone(Window w);
+static Bool superviseinit(void);
+static void supervisespawned(pid_t pid, Bool tab);
+static void supervisetie(int c);
+static void supervisetick(void);
@@ -0,0 +1,203 @@
+/* In-process tab switcher drawn in the bar. Titles are kept case folded per
+ * client by updatetitle() and the match list is narrowed on every key press
+ * rather than rebuilt, ranked by match score and then by recency. */
+static Bool switching = False;
+static char query[256];
+static int qlen, msel, nmatches;
+static Client **matches;
+static int *mscores;
+static unsigned long focusclock;
+
+void
+drawswitcher(void)
+{
+	int i, n, width;
+	char prompt[sizeof(query) + 2];
+	XftColor *col;
+
+	snprintf(prompt, sizeof(prompt), "%s_", query);
+	dc.x = 0;
+	dc.w = MIN(tabwidth, ww);
+	drawtext(prompt, dc.norm);
+	dc.x += dc.w;
+	width = ww - dc.x;
+
+	/* keep the highlighted match in view */
+	n = MIN(nmatches, MAX(1, width / tabwidth));
+	for (i = msel >= n ? msel - n + 1 : 0; i < nmatches && dc.x < ww; i++) {
+		dc.w = MIN(width / n, ww - dc.x);
+		col = i == msel ? dc.sel : matches[i]->urgent ? dc.urg : dc.norm;
+		drawtext(matches[i]->name, col);
+		dc.x += dc.w;
+	}
+	if (dc.x < ww) {
+		dc.w = ww - dc.x;
+		drawtext(NULL, dc.norm);
+	}
+}
+
+void
+switcher(const Arg *arg)
+{
+	if (switching || !nclients)
+		return;
+	#if FULLSCREENBYPASS_PATCH
+	if (fullscreened)
+		return;
+	#endif // FULLSCREENBYPASS_PATCH
+
+	if (XGrabKeyboard(dpy, win, True, GrabModeAsync, GrabModeAsync,
+	                  CurrentTime) != GrabSuccess)
+		return;
+
+	switching = True;
+	#if LAZYTITLES_PATCH
+	refreshtitles(0, nclients);
+	#endif // LAZYTITLES_PATCH
+	query[0] = '\0';
+	qlen = 0;
+	switcherfilter(False);
+	drawbar();
+}
+
+/* Narrowing only rescans the current matches, which is enough as long as the
+ * query only grew since the last call. */
+void
+switcherfilter(Bool narrow)
+{
+	int i, j, n, s, score;
+	Client *c, *hl = nmatches ? matches[msel] : NULL;
+
+	if (!narrow) {
+		matches = erealloc(matches, sizeof(Client *) * MAX(nclients, 1));
+		mscores = erealloc(mscores, sizeof(int) * MAX(nclients, 1));
+		memcpy(matches, clients, sizeof(Client *) * nclients);
+		nmatches = nclients;
+	}
+
+	for (i = n = 0; i < nmatches; i++) {
+		c = matches[i];
+		if ((score = switcherscore(c->fold)) < 0)
+			continue;
+
+		/* insertion sort by score, then by most recently focused */
+		for (j = n++; j > 0; j--) {
+			s = mscores[j - 1];
+			if (s > score || (s == score && matches[j - 1]->lastfocus >= c->lastfocus))
+				break;
+			matches[j] = matches[j - 1];
+			mscores[j] = s;
+		}
+		matches[j] = c;
+		mscores[j] = score;
+	}
+	nmatches = n;
+
+	/* a changed query starts from the best match, a refresh keeps the highlight */
+	for (msel = 0; !narrow && hl && msel < nmatches && matches[msel] != hl; msel++);
+	if (msel >= nmatches || narrow)
+		msel = 0;
+}
+
+void
+switcherkey(XKeyEvent *ev)
+{
+	char buf[32];
+	KeySym ksym = NoSymbol;
+	int c, len;
+
+	len = XLookupString(ev, buf, sizeof(buf), &ksym, NULL);
+
+	switch (ksym) {
+	case XK_Escape:
+		switcherstop();
+		return;
+	case XK_Return:
+	case XK_KP_Enter:
+		for (c = 0; nmatches && c < nclients && clients[c] != matches[msel]; c++);
+		switcherstop();
+		if (nmatches)
+			focus(c);
+		return;
+	case XK_BackSpace:
+		if (!qlen)
+			return;
+		/* remove a whole UTF-8 sequence */
+		while (qlen > 0 && (query[--qlen] & 0xc0) == 0x80);
+		query[qlen] = '\0';
+		nmatches = 0;
+		switcherfilter(False);
+		break;
+	case XK_Tab:
+	case XK_Right:
+	case XK_Down:
+		if (nmatches)
+			msel = (msel + 1) % nmatches;
+		break;
+	case XK_ISO_Left_Tab:
+	case XK_Left:
+	case XK_Up:
+		if (nmatches)
+			msel = (msel + nmatches - 1) % nmatches;
+		break;
+	default:
+		if (len <= 0 || iscntrl((unsigned char)buf[0])
+		    || qlen + len >= sizeof(query))
+			return;
+		memcpy(query + qlen, buf, len);
+		qlen += len;
+		query[qlen] = '\0';
+		switcherfilter(True);
+		break;
+	}
+	drawbar();
+}
+
+/* Returns -1 if the query is not a subsequence of the title, otherwise a
+ * score rewarding consecutive matches and matches at the start of words. */
+int
+switcherscore(const char *title)
+{
+	const char *q, *t, *prev = NULL;
+	int score = 0;
+
+	for (q = query, t = title; *q; q++, t++) {
+		for (; *t && *t != tolower((unsigned char)*q); t++);
+		if (!*t)
+			return -1;
+		if (prev && t == prev + 1)
+			score += 4;
+		if (t == title || !isalnum((unsigned char)t[-1]))
+			score += 2;
+		score++;
+		prev = t;
+	}
+	return score;
+}
+
+void
+switcherstop(void)
+{
+	XUngrabKeyboard(dpy, CurrentTime);
+	switching = False;
+	nmatches = 0;
+	drawbar();
+}
+
+/* Called whenever a title changes or a tab goes away while switching. */
+void
+switcherupdate(int c)
+{
+	char *s, *d;
+
+	if (c > -1) {
+		for (s = clients[c]->name, d = clients[c]->fold; *s; s++, d++)
+			*d = tolower((unsigned char)*s);
+		*d = '\0';
+	}
+
+	if (switching && !nclients)
+		switcherstop();
+	else if (switching)
+		switcherfilter(False);
+}
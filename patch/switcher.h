@@ -0,0 +1,9 @@
+#include <ctype.h>
+
+static void drawswitcher(void);
+static void switcher(const Arg *arg);
+static void switcherfilter(Bool narrow);
+static void switcherkey(XKeyEvent *ev);
+static int switcherscore(const char *title);
+static void switcherstop(void);
+static void switcherupdate(int c);
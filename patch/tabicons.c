@@ -0,0 +1,148 @@
+/* Tab icons are scaled once from the cached _NET_WM_ICON image and uploaded as
+ * a server side picture per client. Redraws only composite that picture; it is
+ * rebuilt when the icon hash or the bar height changes. The kernels are in
+ * iconscale.c. */
+static Timer tabicontimer = { .func = tabicontick };
+
+void
+compositeicon(Picture icon, int x, int y, int s)
+{
+	if (!dc.pict)
+		dc.pict = XRenderCreatePicture(dpy, dc.drawable,
+		          #if ALPHA_PATCH
+		          XRenderFindVisualFormat(dpy, visual),
+		          #else
+		          XRenderFindVisualFormat(dpy, DefaultVisual(dpy, screen)),
+		          #endif // ALPHA_PATCH
+		          0, NULL);
+
+	XRenderComposite(dpy, PictOpOver, icon, None, dc.pict, 0, 0, 0, 0, x, y, s, s);
+}
+
+int
+drawtabicon(void)
+{
+	int s = dc.h - 2, pad = 1;
+
+	#if SEPARATOR_PATCH
+	pad += separator;
+	#endif // SEPARATOR_PATCH
+	#if RASTER_PATCH
+	render->icon(dc.icon, dc.x + pad, dc.y + 1, s);
+	#else
+	compositeicon(dc.icon, dc.x + pad, dc.y + 1, s);
+	#endif // RASTER_PATCH
+	return s + pad;
+}
+
+void
+freetabicon(Client *cl)
+{
+	if (cl->tabpict)
+		XRenderFreePicture(dpy, cl->tabpict);
+	cl->tabpict = None;
+}
+
+unsigned long
+iconhash(const unsigned long *data, unsigned long len)
+{
+	unsigned long i, h = 2166136261UL;
+
+	/* FNV-1a over the 32-bit pixel values */
+	for (i = 0; i < len; i++)
+		h = (h ^ (data[i] & 0xffffffff)) * 16777619UL;
+	return h;
+}
+
+Picture
+tabicon(int c)
+{
+	Client *cl = clients[c];
+	int i, s = dc.h - 2, sw, sh, dw, dh;
+	uint32_t *src, *dst;
+	Pixmap pm;
+	XImage *img;
+	GC gc;
+
+	if (s <= 0)
+		return None;
+
+	if (!cl->icon)
+		return None;
+	if (cl->tabpict && cl->tabpicthash == cl->iconhash && cl->tabpictsize == s)
+		return cl->tabpict;
+
+	freetabicon(cl);
+	sw = cl->icon[0];
+	sh = cl->icon[1];
+	/* fit into a square of the bar height, keeping the aspect ratio */
+	dw = sw >= sh ? s : MAX(1, sw * s / sh);
+	dh = sh >= sw ? s : MAX(1, sh * s / sw);
+
+	src = ecalloc(sw * sh, sizeof(uint32_t));
+	for (i = 0; i < sw * sh; i++)
+		src[i] = cl->icon[i + 2];
+	premultiply(src, sw * sh);
+	dst = ecalloc(s * s, sizeof(uint32_t));
+	scaleicon(src, sw, sh, dst + (s - dh) / 2 * s + (s - dw) / 2, dw, dh, s);
+	free(src);
+
+	pm = XCreatePixmap(dpy, win, s, s, 32);
+	gc = XCreateGC(dpy, pm, 0, NULL);
+	img = XCreateImage(dpy, DefaultVisual(dpy, screen), 32, ZPixmap, 0,
+	                   (char *)dst, s, s, 32, 0);
+	XPutImage(dpy, pm, gc, img, 0, 0, 0, 0, s, s);
+	XDestroyImage(img); /* also frees dst */
+	XFreeGC(dpy, gc);
+
+	cl->tabpict = XRenderCreatePicture(dpy, pm,
+	              XRenderFindStandardFormat(dpy, PictStandardARGB32), 0, NULL);
+	XFreePixmap(dpy, pm);
+	cl->tabpicthash = cl->iconhash;
+	cl->tabpictsize = s;
+
+	return cl->tabpict;
+}
+
+/* Returns when the icon of cl may be fetched again. */
+long long
+tabicondue(Client *cl)
+{
+	return cl->iconfetched ? cl->iconfetched + iconrate : 0;
+}
+
+/* Called when the icon of cl changed. Icons are fetched from a timer and not
+ * while drawing, each tab at most every iconrate ms. */
+void
+tabiconschedule(Client *cl)
+{
+	long long due = tabicondue(cl);
+
+	if (!tabicontimer.expires || due < tabicontimer.expires)
+		settimer(&tabicontimer, due - msnow());
+}
+
+void
+tabicontick(void)
+{
+	long long now = msnow(), due, next = 0;
+	Bool fetched = False;
+	int c;
+
+	for (c = 0; c < nclients; c++) {
+		if (!clients[c]->icondirty)
+			continue;
+		if ((due = tabicondue(clients[c])) > now) {
+			if (!next || due < next)
+				next = due;
+		} else if (fetchicon(c)) {
+			if (c == sel)
+				xseticon();
+			fetched = True;
+		}
+	}
+	if (next)
+		settimer(&tabicontimer, next - now);
+	if (fetched)
+		drawbar();
+}
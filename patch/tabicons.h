@@ -0,0 +1,22 @@
+#include <stdint.h>
+#include <X11/extensions/Xrender.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif // __SSE2__
+
+static void compositeicon(Picture icon, int x, int y, int s);
+static int drawtabicon(void);
+static void freetabicon(Client *cl);
+static unsigned long iconhash(const unsigned long *data, unsigned long len);
+static void premultiply(uint32_t *px, int n);
+#if defined(__AVX2__)
+static void premultiply8(uint32_t *px);
+#endif // __AVX2__
+#if defined(__SSE2__)
+static void premultiply4(uint32_t *px);
+#endif // __SSE2__
+static void scaleicon(const uint32_t *src, int sw, int sh, uint32_t *dst, int dw, int dh, int stride);
+static Picture tabicon(int c);
+static long long tabicondue(Client *cl);
+static void tabiconschedule(Client *cl);
+static void tabicontick(void);
@@ -0,0 +1,214 @@
+/* Client properties are fetched by a worker thread on a connection of its
+ * own, so a slow client or a large property never holds up the main loop.
+ * Finished jobs are handed back through an eventfd and applied in order. */
+static Display *wdpy;
+static pthread_t workerthread;
+static pthread_mutex_t jobmutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobcond = PTHREAD_COND_INITIALIZER;
+static Job *jobs, **jobtail = &jobs, *done, **donetail = &done;
+static Bool workerquit = False;
+static int workerfd = -1;
+static const char *workertitle; /* title handed to updatetitle() */
+
+void
+jobrun(Job *j)
+{
+	Atom *protocols;
+	XWMHints *wmh;
+	int i, n;
+
+	switch (j->type) {
+	case JobTitle:
+		if (!gettextprop(wdpy, j->win, wmatom[WMName], j->name, sizeof(j->name)))
+			gettextprop(wdpy, j->win, XA_WM_NAME, j->name, sizeof(j->name));
+		break;
+	case JobHints:
+		if ((wmh = XGetWMHints(wdpy, j->win))) {
+			j->hashints = True;
+			j->hints = *wmh;
+			XFree(wmh);
+		}
+		break;
+	case JobProtocols:
+		if (XGetWMProtocols(wdpy, j->win, &protocols, &n)) {
+			for (i = 0; i < n; i++)
+				if (protocols[i] == wmatom[WMDelete])
+					j->protodel = True;
+			XFree(protocols);
+		}
+		break;
+	#if ICON_PATCH
+	case JobIcon:
+		j->icon = readicon(wdpy, j->win, &j->iconlen, &j->iconpixmap, &j->iconmask);
+		break;
+	#endif // ICON_PATCH
+	}
+}
+
+void
+workerdone(int fd, short revents)
+{
+	uint64_t n;
+	Job *j, *next;
+	int c;
+
+	read(fd, &n, sizeof(n));
+	pthread_mutex_lock(&jobmutex);
+	j = done;
+	done = NULL;
+	donetail = &done;
+	pthread_mutex_unlock(&jobmutex);
+
+	/* apply everything that finished with a single redraw */
+	drawhold++;
+	for (; j; j = next) {
+		next = j->next;
+		if ((c = getclient(j->win)) > -1) {
+			switch (j->type) {
+			case JobTitle:
+				workertitle = j->name;
+				updatetitle(c);
+				workertitle = NULL;
+				break;
+			case JobHints:
+				#if PROPCACHE_PATCH
+				clients[c]->hints.valid = True;
+				clients[c]->hints.set = j->hashints;
+				clients[c]->hints.hints = j->hints;
+				#endif // PROPCACHE_PATCH
+				if (j->hashints)
+					updatewmhints(c, &j->hints);
+				break;
+			case JobProtocols:
+				clients[c]->protoknown = True;
+				clients[c]->protodel = j->protodel;
+				break;
+			#if ICON_PATCH
+			case JobIcon:
+				storeicon(c, j->icon, j->iconlen, j->iconpixmap, j->iconmask);
+				j->icon = NULL;
+				if (c == sel)
+					xseticon();
+				#if TABICONS_PATCH
+				drawbar();
+				#endif // TABICONS_PATCH
+				break;
+			#endif // ICON_PATCH
+			}
+		}
+		#if ICON_PATCH
+		free(j->icon);
+		#endif // ICON_PATCH
+		free(j);
+	}
+	if (--drawhold == 0 && drawpending) {
+		drawpending = False;
+		drawbar();
+	}
+}
+
+void
+workerinit(void)
+{
+	if (!(wdpy = XOpenDisplay(NULL)))
+		return;
+	fcntl(ConnectionNumber(wdpy), F_SETFD, FD_CLOEXEC);
+	if ((workerfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0
+	    || pthread_create(&workerthread, NULL, workerrun, NULL)) {
+		/* fetch synchronously */
+		if (workerfd >= 0)
+			close(workerfd);
+		workerfd = -1;
+		XCloseDisplay(wdpy);
+		wdpy = NULL;
+		return;
+	}
+	addwatch(workerfd, POLLIN, workerdone);
+}
+
+/* Queues a fetch for client c, returns False if it has to be done in place. */
+Bool
+workerpost(int type, int c)
+{
+	Window w = clients[c]->win;
+	Job *j;
+
+	if (workerfd < 0)
+		return False;
+
+	pthread_mutex_lock(&jobmutex);
+	/* a queued job for the same property will see the latest value */
+	for (j = jobs; j && (j->type != type || j->win != w); j = j->next);
+	if (!j) {
+		j = ecalloc(1, sizeof(*j));
+		j->type = type;
+		j->win = w;
+		*jobtail = j;
+		jobtail = &j->next;
+		pthread_cond_signal(&jobcond);
+	}
+	pthread_mutex_unlock(&jobmutex);
+
+	return True;
+}
+
+void *
+workerrun(void *arg)
+{
+	uint64_t one = 1;
+	Job *j;
+
+	pthread_mutex_lock(&jobmutex);
+	while (!workerquit) {
+		if (!(j = jobs)) {
+			pthread_cond_wait(&jobcond, &jobmutex);
+			continue;
+		}
+		if (!(jobs = j->next))
+			jobtail = &jobs;
+		j->next = NULL;
+		pthread_mutex_unlock(&jobmutex);
+
+		jobrun(j);
+
+		pthread_mutex_lock(&jobmutex);
+		*donetail = j;
+		donetail = &j->next;
+		write(workerfd, &one, sizeof(one));
+	}
+	pthread_mutex_unlock(&jobmutex);
+
+	return NULL;
+}
+
+void
+workerstop(void)
+{
+	Job *j;
+
+	if (workerfd < 0)
+		return;
+
+	pthread_mutex_lock(&jobmutex);
+	workerquit = True;
+	pthread_cond_signal(&jobcond);
+	pthread_mutex_unlock(&jobmutex);
+	pthread_join(workerthread, NULL);
+
+	delwatch(workerfd);
+	close(workerfd);
+	workerfd = -1;
+	for (; jobs; jobs = j) {
+		j = jobs->next;
+		free(jobs);
+	}
+	for (; done; done = j) {
+		j = done->next;
+		#if ICON_PATCH
+		free(done->icon);
+		#endif // ICON_PATCH
+		free(done);
+	}
+	XCloseDisplay(wdpy);
+	wdpy = NULL;
+}
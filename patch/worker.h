@@ -0,0 +1,27 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+enum { JobTitle, JobHints, JobProtocols, JobIcon }; /* property fetches */
+
+typedef struct Job Job;
+struct Job {
+	int type;
+	Window win;
+	char name[256];
+	Bool hashints;
+	XWMHints hints;
+	Bool protodel;
+	#if ICON_PATCH
+	unsigned long *icon, iconlen;
+	Pixmap iconpixmap, iconmask;
+	#endif // ICON_PATCH
+	Job *next;
+};
+
+static void jobrun(Job *j);
+static void workerdone(int fd, short revents);
+static void workerinit(void);
+static Bool workerpost(int type, int c);
+static void *workerrun(void *arg);
+static void workerstop(void);
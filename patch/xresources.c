@@ -1,22 +1,28 @@
+static XrmDatabase xrdb = NULL;
+#if XRESOURCES_RELOAD_PATCH
+static ResourceValue defaults[LENGTH(resources)];
+#endif // XRESOURCES_RELOAD_PATCH
+
 void
 config_init(void)
 {
 	char *resm;
-	XrmDatabase db;
 	ResourcePref *p;
-	Display *dpy;
 
-	if(!(dpy = XOpenDisplay(NULL)))
-		die("Can't open display\n");
+	#if XRESOURCES_RELOAD_PATCH
+	/* resources removed on reload fall back to these */
+	for (p = resources; p < resources + LENGTH(resources); p++)
+		memcpy(&defaults[p - resources], p->dst, resource_size(p->type));
+	#endif // XRESOURCES_RELOAD_PATCH
 
 	XrmInitialize();
 	resm = XResourceManagerString(dpy);
 	if (!resm)
 		return;
 
-	db = XrmGetStringDatabase(resm);
+	xrdb = XrmGetStringDatabase(resm);
 	for (p = resources; p < resources + LENGTH(resources); p++)
-		resource_load(db, p->name, p->type, p->dst);
+		resource_load(xrdb, p->name, p->type, p->dst);
 }
 
 int
@@ -54,26 +60,117 @@ resource_load(XrmDatabase db, char *name, enum resource_type rtype, void *dst)
 }
 
 #if XRESOURCES_RELOAD_PATCH
-static int colors_changed = 0;
-
-void
-xrdb_reload(int sig)
+size_t
+resource_size(enum resource_type rtype)
 {
-	config_init();
-	colors_changed = 1;
-	signal(SIGUSR1, xrdb_reload);
+	return rtype == STRING ? sizeof(char *) : rtype == INTEGER ? sizeof(int) : sizeof(float);
 }
 
+/* Re-reads the resources when the RESOURCE_MANAGER property on the root window
+ * changes, e.g. after xrdb -merge. Only colours and fonts whose values actually
+ * changed are reallocated. */
 void
-writecolors(void)
+xrdb_reload(void)
 {
-	dc.norm[ColBG] = getcolor(normbgcolor);
-	dc.norm[ColFG] = getcolor(normfgcolor);
-	dc.sel[ColBG] = getcolor(selbgcolor);
-	dc.sel[ColFG] = getcolor(selfgcolor);
-	dc.urg[ColBG] = getcolor(urgbgcolor);
-	dc.urg[ColFG] = getcolor(urgfgcolor);
-
-	colors_changed = 0;
+	struct {
+		char **name;
+		XftColor *col;
+	} colors[] = {
+		{ &normbgcolor, &dc.norm[ColBG] },
+		{ &normfgcolor, &dc.norm[ColFG] },
+		{ &selbgcolor,  &dc.sel[ColBG] },
+		{ &selfgcolor,  &dc.sel[ColFG] },
+		{ &urgbgcolor,  &dc.urg[ColBG] },
+		{ &urgfgcolor,  &dc.urg[ColFG] },
+	};
+	char *oldcolors[LENGTH(colors)], *oldfont = font;
+	ResourceValue old;
+	XrmDatabase db;
+	ResourcePref *p;
+	Atom type;
+	int i, format, changed = 0;
+	unsigned long nitems, nleft;
+	unsigned char *resm = NULL;
+	XftFont *oldxfont;
+
+	if (XGetWindowProperty(dpy, root, XA_RESOURCE_MANAGER, 0L, LONG_MAX, False,
+	                       XA_STRING, &type, &format, &nitems, &nleft,
+	                       &resm) != Success || !resm)
+		return;
+	db = XrmGetStringDatabase((char *)resm);
+	XFree(resm);
+	if (!db)
+		return;
+
+	for (i = 0; i < LENGTH(colors); i++)
+		oldcolors[i] = *colors[i].name;
+
+	for (p = resources; p < resources + LENGTH(resources); p++) {
+		memcpy(&old, p->dst, resource_size(p->type));
+		memcpy(p->dst, &defaults[p - resources], resource_size(p->type));
+		resource_load(db, p->name, p->type, p->dst);
+		switch (p->type) {
+		case STRING:
+			changed |= strcmp(old.s, *(char **)p->dst) != 0;
+			break;
+		case INTEGER:
+			changed |= old.i != *(int *)p->dst;
+			break;
+		case FLOAT:
+			changed |= old.f != *(float *)p->dst;
+			break;
+		}
+	}
+
+	for (i = 0; i < LENGTH(colors); i++) {
+		if (!strcmp(oldcolors[i], *colors[i].name))
+			continue;
+		#if ALPHA_PATCH
+		XftColorFree(dpy, visual, cmap, colors[i].col);
+		#else
+		XftColorFree(dpy, DefaultVisual(dpy, screen),
+		             DefaultColormap(dpy, screen), colors[i].col);
+		#endif // ALPHA_PATCH
+		*colors[i].col = getcolor(*colors[i].name);
+		if (colors[i].col == &dc.norm[ColBG])
+			XSetWindowBackground(dpy, win, dc.norm[ColBG].pixel);
+		#if SIDEBAR_PATCH
+		/* the rows only remember which colour set they were drawn with */
+		sidebarreset();
+		#endif // SIDEBAR_PATCH
+	}
+
+	if (strcmp(oldfont, font)) {
+		oldxfont = dc.font.xfont;
+		initfont(font);
+		XftFontClose(dpy, oldxfont);
+		#if BAR_HEIGHT_PATCH
+		dc.h = (barheight ? barheight : dc.font.height + 2);
+		#else
+		dc.h = dc.font.height + 2;
+		#endif // BAR_HEIGHT_PATCH
+		#if AUTOHIDE_PATCH || HIDETABS_PATCH
+		vbh = dc.h;
+		#else
+		if (bh)
+			bh = dc.h;
+		else
+			obh = dc.h;
+		#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
+		if (sel > -1)
+			resize(sel, ww, wh - bh);
+	}
+
+	/* no resource refers to the old database any more */
+	if (xrdb)
+		XrmDestroyDatabase(xrdb);
+	xrdb = db;
+
+	#if LAYOUTCACHE_PATCH
+	/* before and after may have changed */
+	layoutreset();
+	#endif // LAYOUTCACHE_PATCH
+	if (changed)
+		drawbar();
 }
 #endif // XRESOURCES_RELOAD_PATCH
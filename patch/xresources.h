@@ -13,10 +13,16 @@ typedef struct {
 	void *dst;
 } ResourcePref;
 
+typedef union {
+	char *s;
+	int i;
+	float f;
+} ResourceValue;
+
 static void config_init(void);
 static int resource_load(XrmDatabase db, char *name, enum resource_type rtype, void *dst);
 
 #if XRESOURCES_RELOAD_PATCH
-static void xrdb_reload(int sig);
-static void writecolors(void);
+static size_t resource_size(enum resource_type rtype);
+static void xrdb_reload(void);
 #endif // XRESOURCES_RELOAD_PATCH
@@ -9,6 +9,14 @@
 
 /* Patches */
 
+/* Marks a background tab in the bar once the content of its window changes, e.g. build output
+ * or a new chat message. The client windows are watched with the Damage extension (and
+ * redirected with Composite so that hidden tabs still draw), no pixels are fetched. Changes
+ * of the selected tab and of a tab left less than activityrate ms (config.h) ago are ignored;
+ * the mark is cleared by selecting the tab. Needs -lXcomposite -lXdamage.
+ */
+#define ACTIVITY_PATCH 0
+
 /* This patch allows tabbed to handle windows with transparency.
  * You need to uncomment the corresponding line in Makefile to use the -lXrender library
  * when including this patch.
@@ -41,22 +49,101 @@
  */
 #define BOTTOM_TABS_PATCH 0
 
+/* Adds operations on many tabs at once: closeall (MOD+Shift+Alt+q), closeothers (MOD+Shift+q),
+ * closeright (MOD+Alt+q) and detachall (MOD+Shift+d), which hands all tabs back to the window
+ * manager. The requests for all tabs are sent as one batch followed by a single redraw, and
+ * tabbed shuts down the same way instead of focusing every tab in turn. Removing a tab that is
+ * not selected also no longer refocuses the selected one.
+ */
+#define BULKOPS_PATCH 0
+
 /* This patch centers the tab text.
  * https://www.reddit.com/r/suckless/comments/oi4zjl/tabbed_text_alignment/
  * https://github.com/bakkeby/patches/blob/master/tabbed/tabbed-center-0.6-20200512-dabf6a2.diff
  */
 #define CENTER_PATCH 0
 
+/* Publishes the tab list as properties on the tabbed window: _TABBED_CLIENTS (window ids in
+ * tab order), _TABBED_SELECTED (index of the selected tab) and _TABBED_TITLES (null separated
+ * UTF-8 titles in tab order). Switchers can then read the state directly, e.g.
+ *    xprop -id $XEMBED _TABBED_CLIENTS _TABBED_TITLES
+ * instead of walking the window tree with xwininfo.
+ */
+#define CLIENTLIST_PATCH 0
+
 /* This patch prints the position number of the client before the window title.
  * https://tools.suckless.org/tabbed/patches/clientnumber/
  */
 #define CLIENTNUMBER_PATCH 0
 
+/* Adds a resident daemon mode that serves many tabbed windows from one process. Start the
+ * daemon with
+ *    tabbed -D &
+ * and open containers with
+ *    tabbed -a [tabbed arguments] command...
+ * which prints the window id and returns. Every container has its own tabs, window and
+ * settings but shares the X connection, font, glyph cache and colours of the daemon, so a
+ * new container opens without a cold start and costs a few kB of memory. Commands run in
+ * the working directory and environment of tabbed -a. The socket is created in
+ * $XDG_RUNTIME_DIR. If no daemon is running then tabbed -a simply starts up as usual.
+ * Patches that keep state of their own for the window (those using the event loop, and
+ * clientlist, faststartup, fullscreenbypass, layoutcache, propcache, raster, sidebar,
+ * switcher and xresources reload) can not share the process; with any of them the daemon
+ * forks a tabbed process per container instead, which only shares the resolved font.
+ */
+#define DAEMON_PATCH 0
+
 /* Adds support for dragging tabs left and right using the mouse.
  * https://tools.suckless.org/tabbed/patches/drag/
  */
 #define DRAG_PATCH 0
 
+/* Handles X events by priority instead of strictly in arrival order: key and button presses
+ * first, then structural events (map, unmap, destroy, configure), then property changes and
+ * exposures. Cosmetic events are merged while queued and wait whenever input is pending, so a
+ * tab switch is not delayed by a storm of title changes. Start tabbed with -L to print a
+ * histogram of the input handling latency on exit, set eventpriority to 0 in config.h to
+ * measure the same with events handled in arrival order.
+ */
+#define EVENTPRIORITY_PATCH 0
+
+/* Speeds up startup: the resolved font pattern is cached on disk (in $XDG_CACHE_HOME/tabbed,
+ * keyed by the font string and the fontconfig configuration mtime) so later starts skip
+ * fontconfig's configuration loading and font matching. Start tabbed with -B to print how long
+ * each startup phase took until the first frame was drawn.
+ */
+#define FASTSTARTUP_PATCH 0
+
+/* Sizes every tab to its title, between mintabwidth and maxtabwidth (config.h), instead of using
+ * the fixed tabwidth, and shows as many tabs around the selected one as fit. Title widths are
+ * cached per tab and only measured again when the title or the font changes. This depends on the
+ * layoutcache patch and replaces the awesomebar patch.
+ */
+#define FITTABS_PATCH 0
+
+/* Draws characters missing from the font, e.g. CJK or symbols in titles, with the fonts listed
+ * in fallbackfonts (config.h) and then with any font fontconfig finds for them, instead of boxes.
+ * The font drawing each codepoint is looked up once and cached, and every tab keeps its title
+ * split into runs of one font with their widths, so redraws do no font matching.
+ */
+#define FONTFALLBACK_PATCH 0
+
+/* Paces bar redraws to the refresh rate of the output showing the window, read with RandR
+ * (framerate in config.h if that fails). Bursts of title, urgency and drag updates within one
+ * frame are merged into a single redraw on the next frame boundary, bounding the cost of
+ * redrawing the bar however fast clients change their titles.
+ * You need to uncomment the corresponding line in Makefile to use the -lXrandr library
+ * when including this patch.
+ */
+#define FRAMEPACE_PATCH 0
+
+/* While tabbed is fullscreen the selected tab covers the bar and _NET_WM_BYPASS_COMPOSITOR is
+ * set so that a compositor can stop redirecting the window, e.g. for video or games. Bar
+ * redraws, title updates of the other tabs and icon updates are suspended until fullscreen ends,
+ * and the other tabs are only resized once they are selected.
+ */
+#define FULLSCREENBYPASS_PATCH 0
+
 /* This patch hides all the tabs and only shows them when Mod+Shift is pressed. All functions
  * with switching, rotating, and creating tabs involve Mod+Shift. When not doing one of these
  * functions, visibility of the tabs is not needed.
@@ -71,10 +158,24 @@
  * This patch supports both the new EWMH (_NET_WM_ICON) and
  * legacy ICCCM (WM_ICON) ways of setting a window's icon.
  *
+ * Icons are cached per tab and only fetched again when they change. Of a multi-resolution
+ * _NET_WM_ICON only the image closest to iconsize is read, and tabs that keep changing their
+ * icon (e.g. animated favicons) are limited to one fetch per iconrate milliseconds.
+ *
  * https://tools.suckless.org/tabbed/patches/icon/
  */
 #define ICON_PATCH 0
 
+/* Adds a per-instance unix domain control socket served from the main event loop. The
+ * socket is created in $XDG_RUNTIME_DIR as ipcsockpath (config.h) and is exported to clients
+ * as TABBED_SOCKET. It accepts one command per line (list, select, move, spawn, close, detach,
+ * set-title) and all lines received at once are applied as a batch followed by a single
+ * redraw, e.g.
+ *    printf 'select 3\nmove 0\n' | socat - UNIX-CONNECT:$TABBED_SOCKET
+ * See patch/ipc.c for the full protocol.
+ */
+#define IPC_PATCH 0
+
 /* With this patch, handling key input is done with keycodes instead of keysyms making
  * the keyboard layout independent.
  * https://tools.suckless.org/tabbed/patches/keycode/
@@ -87,21 +188,117 @@
  */
 #define KEYRELEASE_PATCH 0
 
+/* Caches the bar layout (first visible tab, number of visible tabs, tab edges and the widths of
+ * before and after) until the window width, the tabs, the selection, tabwidth or the font
+ * change. Clicks and drags find the tab under the pointer with a binary search over the cached
+ * edges, and long titles are shortened by bisection instead of one byte at a time.
+ */
+#define LAYOUTCACHE_PATCH 0
+
+/* Only fetches the titles of the selected tab and of the tabs that fit in the bar. Title changes
+ * of other tabs mark the title as stale and it is fetched once the tab scrolls into view, or when
+ * the switcher or the ipc list command needs all titles. Note that the clientlist patch publishes
+ * the last fetched titles.
+ */
+#define LAZYTITLES_PATCH 0
+
 /* Add a decorative separator bar to the beginning of each tab.
  * https://tools.suckless.org/tabbed/patches/separator/
  */
 #define SEPARATOR_PATCH 0
 
+/* Shows all tabs as a grid of thumbnails in a window covering tabbed. The thumbnails are scaled
+ * from the client windows with the Composite and XRender extensions into a picture kept per
+ * tab, which is only rendered again when the Damage extension reports a change, and at most
+ * every thumbrate ms (config.h) for background tabs. Needs -lXcomposite -lXdamage -lXrender.
+ */
+#define OVERVIEW_PATCH 0
+
+/* Compresses mouse wheel rotation and tab dragging: the wheel steps and pointer motion queued
+ * behind each other are applied as one net rotation or move. With the drag patch a dragged tab
+ * is marked where it would be dropped and the tabs are reordered at most dragrate times per
+ * second (config.h) and on release.
+ */
+#define POINTERCOMPRESS_PATCH 0
+
+/* Shows the cpu usage and resident memory of the process tree of every tab at the right of the
+ * tab, e.g. "12% 340M". A tab is mapped to its _NET_WM_PID, or else to the command tabbed
+ * spawned for it, and the tree below it is found through /proc/<pid>/task/<pid>/children.
+ * All trees are sampled in one pass every procrate ms (config.h) with pread() on files that
+ * are kept open. focusbusy focuses the tab using the most cpu.
+ * This depends on the propcache patch.
+ */
+#define PROCSTATS_PATCH 0
+
+/* Caches WM_PROTOCOLS, WM_HINTS, WM_CLASS and _NET_WM_PID of every tab when it is embedded and
+ * only refetches a property when the client changes it, so closing tabs and handling urgency
+ * hints cost no round trips to the X server. With the ipc patch "info [tab]" prints the cached
+ * pid, class and instance of a tab.
+ */
+#define PROPCACHE_PATCH 0
+
+/* Draws the bar client side instead of with one X request per rectangle and string: fills and
+ * cached glyph coverage masks are composited (using SSE2 / AVX2 when the compiler targets it)
+ * into an image that is uploaded with a single XShmPutImage, or XPutImage when the X server is
+ * not local. This helps most on remote and software rendered X servers. Needs a 24 or 32-bit
+ * TrueColor visual, otherwise (or with rasterbar = 0 in config.h) the usual Xft path is used.
+ * You need to uncomment the corresponding line in Makefile to use the -lXext and -lfreetype
+ * libraries when including this patch.
+ */
+#define RASTER_PATCH 0
+
+/* Lists the tabs as rows in a sidebar on the left or right (sidebarwidth and sidebarright in
+ * config.h) instead of a bar above the clients, for when there are too many tabs for a single
+ * row. Only the rows in view are drawn, scrolling moves the pixels of the rows that stay in
+ * view and a row is only drawn again when its title, colour or icon changed. Not compatible
+ * with the autohide, bottom_tabs, hidetabs and switcher patches, and the raster patch keeps
+ * drawing through the core backend.
+ */
+#define SIDEBAR_PATCH 0
+
+/* Watches every spawned command through a pidfd (Linux 5.3 or later) instead of letting the
+ * kernel reap it. Commands spawned for a new tab are tied to the tab that maps next, and it is
+ * reported when such a command dies before mapping a window, crashes, or keeps running
+ * orphantimeout ms after its window went away, optionally terminating it (config.h). Crashed
+ * tabs, and with -f a command that failed before mapping any tab, are spawned again after
+ * restartdelay ms, doubling with every crash in a row.
+ */
+#define SUPERVISE_PATCH 0
+
+/* Adds a built-in tab switcher (MOD+Shift+grave by default) that is drawn in the bar and
+ * filters tabs by fuzzy matching their titles as you type, ranking the results by match score
+ * and by how recently the tab was used. Tab / arrow keys change the highlighted match, Return
+ * selects it and Escape cancels. Unlike the SETPROP / dmenu approach nothing is spawned.
+ */
+#define SWITCHER_PATCH 0
+
+/* Draws each tab's icon to the left of its title. This depends on the icon patch for the
+ * cached _NET_WM_ICON data. Icons are premultiplied and scaled to the bar height (using
+ * SSE2 / AVX2 when the compiler targets it) once and kept as a picture on the X server, so
+ * redraws only composite the cached picture.
+ * You need to uncomment the corresponding line in Makefile to use the -lXrender library
+ * when including this patch.
+ */
+#define TABICONS_PATCH 0
+
+/* Fetches client properties (titles, WM_HINTS urgency, WM_PROTOCOLS and, with the icon patch,
+ * icons) in a background thread on a second X connection. Results are passed back to the main
+ * loop through an eventfd, so key handling and drawing never wait on a slow client or a large
+ * property. Linux only (eventfd). You may need to add -lpthread to LDFLAGS in the Makefile on
+ * older systems.
+ */
+#define WORKER_PATCH 0
+
 /* This patch allows tabbed colors to be defined via Xresources.
  * https://tools.suckless.org/tabbed/patches/xresources/
  */
 #define XRESOURCES_PATCH 0
 
-/* Expansion of the resources patch above, allows resources to be reloaded during
- * runtime by using a USR1 kill signal.
- *
- * Example use:
- *    pidof tabbed | xargs kill -s USR1
+/* Expansion of the resources patch above, reloads the resources during runtime whenever the
+ * RESOURCE_MANAGER property of the root window changes, e.g. after running
+ *    xrdb -merge ~/.Xresources
+ * Only colors and fonts whose values changed are reallocated and the bar is only redrawn if
+ * any value changed. This replaces the USR1 signal of the original patch.
  *
  * https://tools.suckless.org/tabbed/patches/xresources-with-reload-signal/
  */
@@ -21,6 +21,11 @@
 #include "patches.h"
 #include "arg.h"
 
+#if ACTIVITY_PATCH || OVERVIEW_PATCH
+#include <X11/extensions/Xcomposite.h>
+#include <X11/extensions/Xdamage.h>
+#endif // ACTIVITY_PATCH | OVERVIEW_PATCH
+
 /* XEMBED messages */
 #define XEMBED_EMBEDDED_NOTIFY          0
 #define XEMBED_WINDOW_ACTIVATE          1
@@ -61,6 +66,18 @@ enum {
 	#if ICON_PATCH
 	WMIcon,
 	#endif // ICON_PATCH
+	#if PROPCACHE_PATCH
+	WMPid,
+	#endif // PROPCACHE_PATCH
+	#if FULLSCREENBYPASS_PATCH
+	WMBypassCompositor,
+	#endif // FULLSCREENBYPASS_PATCH
+	#if CLIENTLIST_PATCH
+	WMClients,
+	WMSelected,
+	WMTitles,
+	Utf8String,
+	#endif // CLIENTLIST_PATCH
 	WMLast
 }; /* default atoms */
 
@@ -80,6 +97,21 @@ typedef struct {
 	const Arg arg;
 } Key;
 
+#if FONTFALLBACK_PATCH
+typedef struct {
+	int off, len; /* bytes of the text drawn with one font */
+	int font;     /* see runfont() */
+	int w;
+} TextRun;
+
+typedef struct {
+	char *text;
+	int len, size; /* -1 when the runs are stale */
+	TextRun *run;
+	int nrun, runcap;
+} TextRuns; /* text split by the font drawing it */
+#endif // FONTFALLBACK_PATCH
+
 typedef struct {
 	int x, y, w, h;
 	XftColor norm[ColLast];
@@ -87,6 +119,19 @@ typedef struct {
 	XftColor urg[ColLast];
 	Drawable drawable;
 	GC gc;
+	#if TABICONS_PATCH
+	Picture pict;
+	Picture icon;           /* icon of the tab being drawn, if any */
+	#endif // TABICONS_PATCH
+	#if ACTIVITY_PATCH
+	Bool activity;          /* mark the tab being drawn as changed */
+	#endif // ACTIVITY_PATCH
+	#if PROCSTATS_PATCH
+	const char *stats;      /* usage of the tab being drawn, right aligned */
+	#endif // PROCSTATS_PATCH
+	#if FONTFALLBACK_PATCH
+	TextRuns *runs;         /* runs kept by the tab being drawn, if any */
+	#endif // FONTFALLBACK_PATCH
 	struct {
 		int ascent;
 		int descent;
@@ -95,6 +140,13 @@ typedef struct {
 	} font;
 } DC; /* draw context */
 
+#if PROPCACHE_PATCH
+typedef struct {
+	Bool valid, set;
+	XWMHints hints;
+} HintsCache; /* cached WM_HINTS of a window */
+#endif // PROPCACHE_PATCH
+
 typedef struct {
 	char name[256];
 	#if BASENAME_PATCH
@@ -104,12 +156,70 @@ typedef struct {
 	int tabx;
 	Bool urgent;
 	Bool closed;
+	#if ICON_PATCH
+	unsigned long *icon;    /* cached _NET_WM_ICON image: width, height, pixels */
+	unsigned long iconlen;
+	Pixmap iconpixmap, iconmask;
+	long long iconfetched;
+	Bool icondirty;
+	unsigned long iconserial;
+	#endif // ICON_PATCH
+	#if TABICONS_PATCH
+	Picture tabpict;
+	unsigned long iconhash, tabpicthash;
+	int tabpictsize;
+	#endif // TABICONS_PATCH
+	#if IPC_PATCH
+	Bool fixedtitle;
+	#endif // IPC_PATCH
+	#if FITTABS_PATCH
+	int titlew; /* width of the title, 0 until measured */
+	#endif // FITTABS_PATCH
+	#if FONTFALLBACK_PATCH
+	TextRuns runs;
+	#endif // FONTFALLBACK_PATCH
+	#if FULLSCREENBYPASS_PATCH || LAZYTITLES_PATCH
+	Bool titlestale;
+	#endif // FULLSCREENBYPASS_PATCH | LAZYTITLES_PATCH
+	#if ACTIVITY_PATCH || OVERVIEW_PATCH
+	Damage damage;
+	#endif // ACTIVITY_PATCH | OVERVIEW_PATCH
+	#if ACTIVITY_PATCH
+	Bool activity;          /* the content changed since the tab was last selected */
+	long long actrearm;     /* changes are ignored until then, 0 once they count */
+	#endif // ACTIVITY_PATCH
+	#if OVERVIEW_PATCH
+	Picture thumb;          /* cached thumbnail, thumbw by thumbh pixels */
+	int thumbw, thumbh;
+	Bool thumbdirty;
+	long long thumbtime;    /* when the thumbnail was last rendered */
+	#endif // OVERVIEW_PATCH
+	#if PROPCACHE_PATCH || WORKER_PATCH
+	Bool protoknown, protodel; /* cached WM_DELETE_WINDOW support */
+	#endif // PROPCACHE_PATCH | WORKER_PATCH
+	#if PROPCACHE_PATCH
+	unsigned int propvalid;
+	HintsCache hints;
+	char class[64], instance[64];
+	pid_t pid;
+	#endif // PROPCACHE_PATCH
+	#if PROCSTATS_PATCH
+	pid_t spawnpid;         /* command spawned for the tab, if it has no pid */
+	unsigned long cpu, rss; /* percent of a cpu and kB of its process tree */
+	char usage[24];
+	#endif // PROCSTATS_PATCH
+	#if SWITCHER_PATCH
+	char fold[256];
+	unsigned long lastfocus;
+	#endif // SWITCHER_PATCH
 } Client;
 
 /* function declarations */
 static void buttonpress(const XEvent *e);
 static void cleanup(void);
+static void cleanupwin(void);
 static void clientmessage(const XEvent *e);
+static void closeclient(int c);
 static void configurenotify(const XEvent *e);
 static void configurerequest(const XEvent *e);
 static void createnotify(const XEvent *e);
@@ -124,12 +234,15 @@ static void focus(int c);
 static void focusin(const XEvent *e);
 static void focusonce(const Arg *arg);
 static void focusurgent(const Arg *arg);
+static void freeclient(Client *c);
 static void fullscreen(const Arg *arg);
 static char *getatom(int a);
 static int getclient(Window w);
 static XftColor getcolor(const char *colstr);
+#if !LAYOUTCACHE_PATCH
 static int getfirsttab(void);
-static Bool gettextprop(Window w, Atom atom, char *text, unsigned int size);
+#endif // LAYOUTCACHE_PATCH
+static Bool gettextprop(Display *d, Window w, Atom atom, char *text, unsigned int size);
 static void initfont(const char *fontstr);
 static Bool isprotodel(int c);
 static void keypress(const XEvent *e);
@@ -138,6 +251,7 @@ static void manage(Window win);
 static void maprequest(const XEvent *e);
 static void move(const Arg *arg);
 static void movetab(const Arg *arg);
+static void parseargs(int argc, char *argv[], Bool *detach);
 static void propertynotify(const XEvent *e);
 static void resize(int c, int w, int h);
 static void rotate(const Arg *arg);
@@ -145,13 +259,17 @@ static void run(void);
 static void sendxembed(int c, long msg, long detail, long d1, long d2);
 static void setcmd(int argc, char *argv[], int);
 static void setup(void);
+static void setupwin(void);
 static void spawn(const Arg *arg);
+static void spawnchild(const Arg *arg, Bool tab);
 static int textnw(const char *text, unsigned int len);
 static void toggle(const Arg *arg);
 static void unmanage(int c);
 static void unmapnotify(const XEvent *e);
 static void updatenumlockmask(void);
 static void updatetitle(int c);
+static void updatewmhints(int c, XWMHints *wmh);
+static void usage(void);
 static int xerror(Display *dpy, XErrorEvent *ee);
 static void xsettitle(Window w, const char *str);
 
@@ -161,6 +279,9 @@ static void xsettitle(Window w, const char *str);
 static int screen;
 static void (*handler[LASTEvent]) (const XEvent *) = {
 	[ButtonPress] = buttonpress,
+	#if DRAG_PATCH && POINTERCOMPRESS_PATCH
+	[ButtonRelease] = buttonrelease,
+	#endif // DRAG_PATCH && POINTERCOMPRESS_PATCH
 	[ClientMessage] = clientmessage,
 	[ConfigureNotify] = configurenotify,
 	[ConfigureRequest] = configurerequest,
@@ -190,6 +311,30 @@ static Bool running = True, nextfocus, doinitspawn = True,
 static Display *dpy;
 static DC dc;
 static Atom wmatom[WMLast];
+static char *atomnames[WMLast] = {
+	[WMProtocols] = "WM_PROTOCOLS",
+	[WMDelete] = "WM_DELETE_WINDOW",
+	[WMName] = "_NET_WM_NAME",
+	[WMState] = "_NET_WM_STATE",
+	[WMFullscreen] = "_NET_WM_STATE_FULLSCREEN",
+	[XEmbed] = "_XEMBED",
+	[WMSelectTab] = "_TABBED_SELECT_TAB",
+	#if ICON_PATCH
+	[WMIcon] = "_NET_WM_ICON",
+	#endif // ICON_PATCH
+	#if PROPCACHE_PATCH
+	[WMPid] = "_NET_WM_PID",
+	#endif // PROPCACHE_PATCH
+	#if FULLSCREENBYPASS_PATCH
+	[WMBypassCompositor] = "_NET_WM_BYPASS_COMPOSITOR",
+	#endif // FULLSCREENBYPASS_PATCH
+	#if CLIENTLIST_PATCH
+	[WMClients] = "_TABBED_CLIENTS",
+	[WMSelected] = "_TABBED_SELECTED",
+	[WMTitles] = "_TABBED_TITLES",
+	[Utf8String] = "UTF8_STRING",
+	#endif // CLIENTLIST_PATCH
+};
 static Window root, win;
 static Client **clients;
 static int nclients, sel = -1, lastsel = -1;
@@ -202,6 +347,10 @@ static const char *geometry;
 #if HIDETABS_PATCH
 static Bool barvisibility = False;
 #endif // HIDETABS_PATCH
+#if EVENTPRIORITY_PATCH || FULLSCREENBYPASS_PATCH || IPC_PATCH || LAZYTITLES_PATCH || WORKER_PATCH
+static int drawhold;
+static Bool drawpending;
+#endif // EVENTPRIORITY_PATCH | FULLSCREENBYPASS_PATCH | IPC_PATCH | LAZYTITLES_PATCH | WORKER_PATCH
 
 #if ALPHA_PATCH
 static Colormap cmap;
@@ -219,9 +368,26 @@ void
 buttonpress(const XEvent *e)
 {
 	const XButtonPressedEvent *ev = &e->xbutton;
-	int i, fc;
+	int i;
+	#if !LAYOUTCACHE_PATCH && !SIDEBAR_PATCH
+	int fc;
+	#endif // LAYOUTCACHE_PATCH | SIDEBAR_PATCH
+	#if !POINTERCOMPRESS_PATCH
 	Arg arg;
+	#endif // POINTERCOMPRESS_PATCH
 
+	#if OVERVIEW_PATCH
+	if (overviewing) {
+		if (ev->window == ovwin && ev->button == Button1)
+			overviewclick(ev->x, ev->y);
+		return;
+	}
+	#endif // OVERVIEW_PATCH
+
+	#if SIDEBAR_PATCH
+	if ((i = sidebarhit(ev->x, ev->y)) < 0)
+		return;
+	#else
 	#if BOTTOM_TABS_PATCH
 	if (ev->y < wh - bh)
 	#else
@@ -229,48 +395,83 @@ buttonpress(const XEvent *e)
 	#endif // BOTTOM_TABS_PATCH
 		return;
 
+	#if LAYOUTCACHE_PATCH
+	if ((i = layouthit(ev->x)) < 0)
+		return;
+	#else
 	if (((fc = getfirsttab()) > 0 && ev->x < TEXTW(before)) || ev->x < 0)
 		return;
 
-	for (i = fc; i < nclients; i++) {
-		if (clients[i]->tabx > ev->x) {
-			switch (ev->button) {
-			case Button1:
-				focus(i);
-				break;
-			case Button2:
-				focus(i);
-				killclient(NULL);
-				break;
-			case Button4: /* FALLTHROUGH */
-			case Button5:
-				arg.i = ev->button == Button4 ? -1 : 1;
-				rotate(&arg);
-				break;
-			}
-			break;
-		}
+	for (i = fc; i < nclients && clients[i]->tabx <= ev->x; i++);
+	if (i >= nclients)
+		return;
+	#endif // LAYOUTCACHE_PATCH
+	#endif // SIDEBAR_PATCH
+
+	switch (ev->button) {
+	case Button1:
+		focus(i);
+		break;
+	case Button2:
+		focus(i);
+		killclient(NULL);
+		break;
+	case Button4: /* FALLTHROUGH */
+	case Button5:
+		#if POINTERCOMPRESS_PATCH
+		wheeldelta += ev->button == Button4 ? -1 : 1;
+		#else
+		arg.i = ev->button == Button4 ? -1 : 1;
+		rotate(&arg);
+		#endif // POINTERCOMPRESS_PATCH
+		break;
 	}
 }
 
 void
 cleanup(void)
+{
+	#if WORKER_PATCH
+	workerstop();
+	#endif // WORKER_PATCH
+	#if EVENTPRIORITY_PATCH
+	latencyreport();
+	#endif // EVENTPRIORITY_PATCH
+	#if RASTER_PATCH
+	rasterfree();
+	rasterfreeglyphs();
+	#endif // RASTER_PATCH
+	XFreeGC(dpy, dc.gc);
+	XSync(dpy, False);
+}
+
+/* Closes the tabs and the window. */
+void
+cleanupwin(void)
 {
 	int i;
 
+	#if BULKOPS_PATCH
+	closeclients(0, nclients, -1);
+	for (i = 0; i < nclients; i++)
+		XReparentWindow(dpy, clients[i]->win, root, 0, 0);
+	dropclients(0, nclients, False);
+	#else
 	for (i = 0; i < nclients; i++) {
 		focus(i);
 		killclient(NULL);
 		XReparentWindow(dpy, clients[i]->win, root, 0, 0);
 		unmanage(i);
 	}
+	#endif // BULKOPS_PATCH
 	free(clients);
 	clients = NULL;
 
+	#if IPC_PATCH
+	ipccleanup();
+	#endif // IPC_PATCH
 	XFreePixmap(dpy, dc.drawable);
-	XFreeGC(dpy, dc.gc);
 	XDestroyWindow(dpy, win);
-	XSync(dpy, False);
 	free(cmd);
 }
 
@@ -289,6 +490,25 @@ clientmessage(const XEvent *e)
 	}
 }
 
+void
+closeclient(int c)
+{
+	XEvent ev;
+
+	if (isprotodel(c) && !clients[c]->closed) {
+		ev.type = ClientMessage;
+		ev.xclient.window = clients[c]->win;
+		ev.xclient.message_type = wmatom[WMProtocols];
+		ev.xclient.format = 32;
+		ev.xclient.data.l[0] = wmatom[WMDelete];
+		ev.xclient.data.l[1] = CurrentTime;
+		XSendEvent(dpy, clients[c]->win, False, NoEventMask, &ev);
+		clients[c]->closed = True;
+	} else {
+		XKillClient(dpy, clients[c]->win);
+	}
+}
+
 void
 configurenotify(const XEvent *e)
 {
@@ -297,6 +517,11 @@ configurenotify(const XEvent *e)
 	if (ev->window == win && (ev->width != ww || ev->height != wh)) {
 		ww = ev->width;
 		wh = ev->height;
+		#if TABICONS_PATCH
+		if (dc.pict)
+			XRenderFreePicture(dpy, dc.pict);
+		dc.pict = None;
+		#endif // TABICONS_PATCH
 		XFreePixmap(dpy, dc.drawable);
 		#if ALPHA_PATCH
 		dc.drawable = XCreatePixmap(dpy, win, ww, wh,
@@ -314,10 +539,18 @@ configurenotify(const XEvent *e)
 			obh = 0;
 		}
 
+		#if SIDEBAR_PATCH
+		sidebarreset();
+		#endif // SIDEBAR_PATCH
+
 		if (sel > -1)
 			resize(sel, ww, wh - bh);
 		XSync(dpy, False);
 	}
+	#if FRAMEPACE_PATCH
+	if (ev->window == win)
+		frameoutput();
+	#endif // FRAMEPACE_PATCH
 }
 
 void
@@ -328,10 +561,24 @@ configurerequest(const XEvent *e)
 	int c;
 
 	if ((c = getclient(ev->window)) > -1) {
+		#if SIDEBAR_PATCH
+		wc.x = sidebarright ? 0 : sidebarwidth;
+		wc.y = 0;
+		wc.width = MAX(1, ww - sidebarwidth);
+		wc.height = wh;
+		#if FULLSCREENBYPASS_PATCH
+		/* same as resize(), the sidebar is not shown while fullscreen */
+		if (fullscreened) {
+			wc.x = 0;
+			wc.width = ww;
+		}
+		#endif // FULLSCREENBYPASS_PATCH
+		#else
 		wc.x = 0;
 		wc.y = bh;
 		wc.width = ww;
 		wc.height = wh - bh;
+		#endif // SIDEBAR_PATCH
 		wc.border_width = 0;
 		wc.sibling = ev->above;
 		wc.stack_mode = ev->detail;
@@ -354,8 +601,12 @@ destroynotify(const XEvent *e)
 	const XDestroyWindowEvent *ev = &e->xdestroywindow;
 	int c;
 
-	if ((c = getclient(ev->window)) > -1)
+	if ((c = getclient(ev->window)) > -1) {
+		#if SUPERVISE_PATCH
+		supervisegone(ev->window);
+		#endif // SUPERVISE_PATCH
 		unmanage(c);
+	}
 }
 
 void
@@ -374,6 +625,9 @@ drawbar(void)
 {
 	XftColor *col;
 	int c, cc, fc, width;
+	#if LAYOUTCACHE_PATCH
+	Layout *l;
+	#endif // LAYOUTCACHE_PATCH
 	#if AUTOHIDE_PATCH || HIDETABS_PATCH
 	int nbh;
 	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
@@ -387,10 +641,20 @@ drawbar(void)
 	int by = 0;
 	#endif // BOTTOM_TABS_PATCH
 
-	#if XRESOURCES_PATCH && XRESOURCES_RELOAD_PATCH
-	if (colors_changed)
-		writecolors();
-	#endif // XRESOURCES_RELOAD_PATCH
+	#if EVENTPRIORITY_PATCH || FULLSCREENBYPASS_PATCH || IPC_PATCH || LAZYTITLES_PATCH || WORKER_PATCH
+	if (drawhold) {
+		drawpending = True;
+		return;
+	}
+	#endif // EVENTPRIORITY_PATCH | FULLSCREENBYPASS_PATCH | IPC_PATCH | LAZYTITLES_PATCH | WORKER_PATCH
+	#if FRAMEPACE_PATCH
+	if (framedefer())
+		return;
+	#endif // FRAMEPACE_PATCH
+
+	#if CLIENTLIST_PATCH
+	publishclients();
+	#endif // CLIENTLIST_PATCH
 
 	#if AUTOHIDE_PATCH || HIDETABS_PATCH
 	#if AUTOHIDE_PATCH && HIDETABS_PATCH
@@ -400,6 +664,10 @@ drawbar(void)
 	#elif AUTOHIDE_PATCH
 	nbh = nclients > 1 ? vbh : 0;
 	#endif
+	#if SWITCHER_PATCH
+	if (switching)
+		nbh = vbh;
+	#endif // SWITCHER_PATCH
 	if (nbh != bh) {
 		bh = nbh;
 		#if BOTTOM_TABS_PATCH
@@ -414,12 +682,28 @@ drawbar(void)
 	}
 	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
 
+	#if OVERVIEW_PATCH
+	if (overviewing) {
+		drawoverview();
+		return;
+	}
+	#endif // OVERVIEW_PATCH
+
+	#if SIDEBAR_PATCH
+	drawsidebar();
+	return;
+	#endif // SIDEBAR_PATCH
+
 	if (nclients == 0) {
 		dc.x = 0;
 		dc.w = ww;
 		XFetchName(dpy, win, &name);
 		drawtext(name ? name : "", dc.norm);
-		#if AUTOHIDE_PATCH
+		#if RASTER_PATCH && AUTOHIDE_PATCH
+		render->flush(by, vbh);
+		#elif RASTER_PATCH
+		render->flush(by, bh);
+		#elif AUTOHIDE_PATCH
 		XCopyArea(dpy, dc.drawable, win, dc.gc, 0, 0, ww, vbh, 0, by);
 		#else
 		XCopyArea(dpy, dc.drawable, win, dc.gc, 0, 0, ww, bh, 0, by);
@@ -434,11 +718,43 @@ drawbar(void)
 		return;
 	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
 
+	#if SWITCHER_PATCH
+	if (switching) {
+		drawswitcher();
+		#if RASTER_PATCH
+		render->flush(by, bh);
+		#else
+		XCopyArea(dpy, dc.drawable, win, dc.gc, 0, 0, ww, bh, 0, by);
+		#endif // RASTER_PATCH
+		XSync(dpy, False);
+		return;
+	}
+	#endif // SWITCHER_PATCH
+
 	width = ww;
 
 	#if AWESOMEBAR_PATCH
 	tabwidth = ww / nclients;
 	#endif // AWESOMEBAR_PATCH
+	#if LAYOUTCACHE_PATCH
+	l = getlayout();
+	fc = l->fc;
+	cc = l->cc;
+	if (l->afterw) {
+		dc.w = l->afterw;
+		dc.x = width - dc.w;
+		drawtext(after, dc.sel);
+		width -= dc.w;
+	}
+	dc.x = 0;
+
+	if (l->beforew) {
+		dc.w = l->beforew;
+		drawtext(before, dc.sel);
+		dc.x += dc.w;
+		width -= dc.w;
+	}
+	#else
 	cc = ww / tabwidth;
 	if (nclients > cc)
 		cc = (ww - TEXTW(before) - TEXTW(after)) / tabwidth;
@@ -459,6 +775,11 @@ drawbar(void)
 	}
 
 	cc = MIN(cc, nclients);
+	#endif // LAYOUTCACHE_PATCH
+	#if LAZYTITLES_PATCH
+	refreshtitles(fc, fc + cc);
+	drawpending = False;
+	#endif // LAZYTITLES_PATCH
 	for (c = fc; c < fc + cc; c++) {
 		dc.w = width / cc;
 		if (c == sel) {
@@ -467,6 +788,21 @@ drawbar(void)
 		} else {
 			col = clients[c]->urgent ? dc.urg : dc.norm;
 		}
+		#if FITTABS_PATCH
+		dc.w = l->x[c - fc] - dc.x;
+		#endif // FITTABS_PATCH
+		#if TABICONS_PATCH
+		dc.icon = tabicon(c);
+		#endif // TABICONS_PATCH
+		#if ACTIVITY_PATCH
+		dc.activity = clients[c]->activity;
+		#endif // ACTIVITY_PATCH
+		#if PROCSTATS_PATCH
+		dc.stats = clients[c]->usage;
+		#endif // PROCSTATS_PATCH
+		#if FONTFALLBACK_PATCH
+		dc.runs = &clients[c]->runs;
+		#endif // FONTFALLBACK_PATCH
 		#if CLIENTNUMBER_PATCH && BASENAME_PATCH
 		snprintf(tabtitle, sizeof(tabtitle), "%d: %s",
 		         c + 1, basenametitles ? clients[c]->basename : clients[c]->name);
@@ -480,20 +816,58 @@ drawbar(void)
 		#else
 		drawtext(clients[c]->name, col);
 		#endif // CLIENTNUMBER_PATCH
+		#if TABICONS_PATCH
+		dc.icon = None;
+		#endif // TABICONS_PATCH
+		#if ACTIVITY_PATCH
+		dc.activity = False;
+		#endif // ACTIVITY_PATCH
+		#if PROCSTATS_PATCH
+		dc.stats = NULL;
+		#endif // PROCSTATS_PATCH
+		#if FONTFALLBACK_PATCH
+		dc.runs = NULL;
+		#endif // FONTFALLBACK_PATCH
 		dc.x += dc.w;
 		clients[c]->tabx = dc.x;
 	}
+	#if RASTER_PATCH
+	render->flush(by, bh);
+	#else
 	XCopyArea(dpy, dc.drawable, win, dc.gc, 0, 0, ww, bh, 0, by);
+	#endif // RASTER_PATCH
 	XSync(dpy, False);
 }
 
 void
 drawtext(const char *text, XftColor col[ColLast])
 {
-	int i, j, x, y, h, len, olen;
+	int i, j, x, y, h, w, len, olen;
+	#if TABICONS_PATCH
+	int iw = 0;
+	#endif // TABICONS_PATCH
+	#if PROCSTATS_PATCH
+	int sw = 0;
+	#endif // PROCSTATS_PATCH
 	char buf[256];
+	#if LAYOUTCACHE_PATCH
+	int lo, hi;
+	#endif // LAYOUTCACHE_PATCH
+	#if FONTFALLBACK_PATCH
+	TextRuns *tr;
+	#elif !RASTER_PATCH
 	XftDraw *d;
+	#endif // FONTFALLBACK_PATCH
+
+	#if RASTER_PATCH
 	#if SEPARATOR_PATCH
+	if (separator)
+		render->fill(dc.x, dc.y, separator, dc.h, &col[ColFG]);
+	render->fill(dc.x + separator, dc.y, dc.w - separator, dc.h, &col[ColBG]);
+	#else
+	render->fill(dc.x, dc.y, dc.w, dc.h, &col[ColBG]);
+	#endif // SEPARATOR_PATCH
+	#elif SEPARATOR_PATCH
 	XRectangle tab = { dc.x+separator, dc.y, dc.w-separator, dc.h };
 	XRectangle sep = { dc.x, dc.y, separator, dc.h };
 
@@ -510,6 +884,19 @@ drawtext(const char *text, XftColor col[ColLast])
 	XFillRectangles(dpy, dc.drawable, dc.gc, &r, 1);
 	#endif // SEPARATOR_PATCH
 
+	#if TABICONS_PATCH
+	if (dc.icon)
+		iw = drawtabicon();
+	#endif // TABICONS_PATCH
+	#if ACTIVITY_PATCH
+	if (dc.activity)
+		drawactivity(col);
+	#endif // ACTIVITY_PATCH
+	#if PROCSTATS_PATCH
+	if (dc.stats && *dc.stats)
+		sw = drawstats(col);
+	#endif // PROCSTATS_PATCH
+
 	if (!text)
 		return;
 
@@ -517,10 +904,38 @@ drawtext(const char *text, XftColor col[ColLast])
 	h = dc.font.ascent + dc.font.descent;
 	y = dc.y + (dc.h / 2) - (h / 2) + dc.font.ascent;
 	x = dc.x + (h / 2);
+	#if TABICONS_PATCH
+	x += iw;
+	#endif // TABICONS_PATCH
 
 	/* shorten text if necessary */
-	for (len = MIN(olen, sizeof(buf));
-		len && textnw(text, len) > dc.w - h; len--);
+	#if TABICONS_PATCH
+	w = dc.w - h - iw;
+	#else
+	w = dc.w - h;
+	#endif // TABICONS_PATCH
+	#if PROCSTATS_PATCH
+	w -= sw;
+	#endif // PROCSTATS_PATCH
+	#if FONTFALLBACK_PATCH
+	/* textnw() below measures prefixes of these runs */
+	tr = getruns(dc.runs ? dc.runs : &scratch, text, MIN(olen, sizeof(buf)));
+	#endif // FONTFALLBACK_PATCH
+	#if LAYOUTCACHE_PATCH
+	/* the width only grows with the length, so bisect instead of measuring
+	 * every shorter prefix */
+	if (textnw(text, (len = MIN(olen, sizeof(buf)))) > w) {
+		for (lo = 0, hi = len - 1; lo < hi;) {
+			if (textnw(text, (len = (lo + hi + 1) / 2)) > w)
+				hi = len - 1;
+			else
+				lo = len;
+		}
+		len = lo;
+	}
+	#else
+	for (len = MIN(olen, sizeof(buf)); len && textnw(text, len) > w; len--);
+	#endif // LAYOUTCACHE_PATCH
 
 	if (!len)
 		return;
@@ -531,9 +946,14 @@ drawtext(const char *text, XftColor col[ColLast])
 	}
 	#if CENTER_PATCH
 	else
-		x += (dc.w - TEXTW(buf)) / 2; // center text
+		x += (w + h - TEXTW(buf)) / 2; // center text
 	#endif // CENTER_PATCH
 
+	#if FONTFALLBACK_PATCH
+	drawruns(tr, x, y, &col[ColFG], len, len < olen ? titletrim : NULL);
+	#elif RASTER_PATCH
+	render->text(x, y, &col[ColFG], buf, len);
+	#else
 	#if ALPHA_PATCH
 	d = XftDrawCreate(dpy, dc.drawable, visual, cmap);
 	#else
@@ -541,6 +961,7 @@ drawtext(const char *text, XftColor col[ColLast])
 	#endif // ALPHA_PATCH
 	XftDrawStringUtf8(d, &col[ColFG], dc.font.xfont, x, y, (XftChar8 *) buf, len);
 	XftDrawDestroy(d);
+	#endif // RASTER_PATCH
 }
 
 void *
@@ -568,8 +989,16 @@ expose(const XEvent *e)
 {
 	const XExposeEvent *ev = &e->xexpose;
 
-	if (ev->count == 0 && win == ev->window)
+	if (ev->count == 0 && win == ev->window) {
+		#if SIDEBAR_PATCH
+		sidebarreset();
+		#endif // SIDEBAR_PATCH
 		drawbar();
+	}
+	#if OVERVIEW_PATCH
+	if (ev->count == 0 && overviewing && ovwin == ev->window)
+		drawoverview();
+	#endif // OVERVIEW_PATCH
 }
 
 void
@@ -590,6 +1019,7 @@ focus(int c)
 		#if ICON_PATCH
 		XChangeProperty(dpy, win, wmatom[WMIcon], XA_CARDINAL, 32,
 				PropModeReplace, (unsigned char *) icon, ICON_WIDTH * ICON_HEIGHT + 2);
+		iconowner = None;
 		#endif // ICON_PATCH
 		XRaiseWindow(dpy, win);
 
@@ -607,16 +1037,37 @@ focus(int c)
 	xsettitle(win, clients[c]->name);
 
 	if (sel != c) {
+		#if ACTIVITY_PATCH
+		if (sel > -1 && sel < nclients)
+			activityleave(clients[sel]);
+		#endif // ACTIVITY_PATCH
 		lastsel = sel;
 		sel = c;
 	}
+	#if FULLSCREENBYPASS_PATCH
+	/* the title was not fetched while the tab was hidden */
+	if (clients[c]->titlestale && fullscreened)
+		updatetitle(c);
+	#endif // FULLSCREENBYPASS_PATCH
+	#if ACTIVITY_PATCH
+	clients[c]->activity = False;
+	#endif // ACTIVITY_PATCH
+	#if SWITCHER_PATCH
+	clients[c]->lastfocus = ++focusclock;
+	#endif // SWITCHER_PATCH
 	#if ICON_PATCH
 	xseticon();
 	#endif // ICON_PATCH
 
+	#if PROPCACHE_PATCH
+	if (clients[c]->urgent && (wmh = gethints(c))) {
+		wmh->flags &= ~XUrgencyHint;
+		sethints(c, wmh);
+	#else
 	if (clients[c]->urgent && (wmh = XGetWMHints(dpy, clients[c]->win))) {
 		wmh->flags &= ~XUrgencyHint;
 		XSetWMHints(dpy, clients[c]->win, wmh);
+	#endif // PROPCACHE_PATCH
 		clients[c]->urgent = False;
 		XFree(wmh);
 
@@ -625,9 +1076,15 @@ focus(int c)
 		 * if we clear only the client hint and don't clear the
 		 * hint from the main container window
 		 */
+		#if PROPCACHE_PATCH
+		if ((win_wmh = gethints(-1))) {
+			win_wmh->flags &= ~XUrgencyHint;
+			sethints(-1, win_wmh);
+		#else
 		if ((win_wmh = XGetWMHints(dpy, win))) {
 			win_wmh->flags &= ~XUrgencyHint;
 			XSetWMHints(dpy, win, win_wmh);
+		#endif // PROPCACHE_PATCH
 			XFree(win_wmh);
 		}
 	}
@@ -672,6 +1129,25 @@ focusurgent(const Arg *arg)
 	}
 }
 
+/* Frees c along with everything it holds. */
+void
+freeclient(Client *c)
+{
+	#if ICON_PATCH
+	free(c->icon);
+	#endif // ICON_PATCH
+	#if TABICONS_PATCH
+	freetabicon(c);
+	#endif // TABICONS_PATCH
+	#if DAMAGEWATCH
+	damageunmanage(c);
+	#endif // DAMAGEWATCH
+	#if FONTFALLBACK_PATCH
+	fallbackfree(&c->runs);
+	#endif // FONTFALLBACK_PATCH
+	free(c);
+}
+
 void
 fullscreen(const Arg *arg)
 {
@@ -725,6 +1201,10 @@ getcolor(const char *colstr)
 {
 	XftColor color;
 
+	#if DAEMONSHARED
+	if (daemoncolor(colstr, &color))
+		return color;
+	#endif // DAEMONSHARED
 	#if ALPHA_PATCH
 	if (!XftColorAllocName(dpy, visual, cmap, colstr, &color))
 	#else
@@ -735,6 +1215,7 @@ getcolor(const char *colstr)
 	return color;
 }
 
+#if !LAYOUTCACHE_PATCH
 int
 getfirsttab(void)
 {
@@ -752,9 +1233,10 @@ getfirsttab(void)
 	       ret + cc > nclients ? MAX(0, nclients - cc) :
 	       ret;
 }
+#endif // LAYOUTCACHE_PATCH
 
 Bool
-gettextprop(Window w, Atom atom, char *text, unsigned int size)
+gettextprop(Display *d, Window w, Atom atom, char *text, unsigned int size)
 {
 	char **list = NULL;
 	int n;
@@ -764,13 +1246,13 @@ gettextprop(Window w, Atom atom, char *text, unsigned int size)
 		return False;
 
 	text[0] = '\0';
-	XGetTextProperty(dpy, w, &name, atom);
+	XGetTextProperty(d, w, &name, atom);
 	if (!name.nitems)
 		return False;
 
 	if (name.encoding == XA_STRING) {
 		strncpy(text, (char *)name.value, size - 1);
-	} else if (XmbTextPropertyToTextList(dpy, &name, &list, &n) >= Success
+	} else if (XmbTextPropertyToTextList(d, &name, &list, &n) >= Success
 	           && n > 0 && *list) {
 		strncpy(text, *list, size - 1);
 		XFreeStringList(list);
@@ -784,13 +1266,39 @@ gettextprop(Window w, Atom atom, char *text, unsigned int size)
 void
 initfont(const char *fontstr)
 {
-	if (!(dc.font.xfont = XftFontOpenName(dpy, screen, fontstr))
+	dc.font.xfont = NULL;
+	#if LAYOUTCACHE_PATCH
+	layoutreset();
+	#endif // LAYOUTCACHE_PATCH
+	#if SIDEBAR_PATCH
+	sidebarreset();
+	#endif // SIDEBAR_PATCH
+	#if RASTER_PATCH
+	rasterfreeglyphs();
+	#endif // RASTER_PATCH
+	#if FONTFALLBACK_PATCH
+	fallbackreset(fontstr);
+	#endif // FONTFALLBACK_PATCH
+	#if DAEMON_PATCH && !DAEMONSHARED
+	/* reuse the pattern resolved by the daemon if there is one */
+	if (daemonfont && !strcmp(fontstr, daemonfontname))
+		dc.font.xfont = XftFontOpenPattern(dpy, FcPatternDuplicate(daemonfont));
+	#endif // DAEMON_PATCH
+	#if FASTSTARTUP_PATCH
+	if (!dc.font.xfont && !(dc.font.xfont = fontcacheopen(fontstr))
+	    && (dc.font.xfont = XftFontOpenName(dpy, screen, fontstr)))
+		fontcachesave(fontstr, dc.font.xfont);
+	#endif // FASTSTARTUP_PATCH
+	if (!dc.font.xfont && !(dc.font.xfont = XftFontOpenName(dpy, screen, fontstr))
 	    && !(dc.font.xfont = XftFontOpenName(dpy, screen, "fixed")))
 		die("error, cannot load font: '%s'\n", fontstr);
 
 	dc.font.ascent = dc.font.xfont->ascent;
 	dc.font.descent = dc.font.xfont->descent;
 	dc.font.height = dc.font.ascent + dc.font.descent;
+	#if FONTFALLBACK_PATCH
+	fallbacktitles(0, nclients);
+	#endif // FONTFALLBACK_PATCH
 }
 
 Bool
@@ -800,6 +1308,10 @@ isprotodel(int c)
 	Atom *protocols;
 	Bool ret = False;
 
+	#if PROPCACHE_PATCH || WORKER_PATCH
+	if (clients[c]->protoknown)
+		return clients[c]->protodel;
+	#endif // PROPCACHE_PATCH | WORKER_PATCH
 	if (XGetWMProtocols(dpy, clients[c]->win, &protocols, &n)) {
 		for (i = 0; !ret && i < n; i++) {
 			if (protocols[i] == wmatom[WMDelete])
@@ -808,6 +1320,11 @@ isprotodel(int c)
 		XFree(protocols);
 	}
 
+	#if PROPCACHE_PATCH
+	clients[c]->protoknown = True;
+	clients[c]->protodel = ret;
+	#endif // PROPCACHE_PATCH
+
 	return ret;
 }
 
@@ -818,7 +1335,22 @@ keypress(const XEvent *e)
 	unsigned int i;
 	#if !KEYCODE_PATCH
 	KeySym keysym;
+	#endif // KEYCODE_PATCH
+
+	#if SWITCHER_PATCH
+	if (switching) {
+		switcherkey((XKeyEvent *)ev);
+		return;
+	}
+	#endif // SWITCHER_PATCH
+	#if OVERVIEW_PATCH
+	if (overviewing) {
+		overviewkey((XKeyEvent *)ev);
+		return;
+	}
+	#endif // OVERVIEW_PATCH
 
+	#if !KEYCODE_PATCH
 	keysym = XkbKeycodeToKeysym(dpy, (KeyCode)ev->keycode, 0, 0);
 	#endif // KEYCODE_PATCH
 	for (i = 0; i < LENGTH(keys); i++) {
@@ -837,23 +1369,10 @@ keypress(const XEvent *e)
 void
 killclient(const Arg *arg)
 {
-	XEvent ev;
-
 	if (sel < 0)
 		return;
 
-	if (isprotodel(sel) && !clients[sel]->closed) {
-		ev.type = ClientMessage;
-		ev.xclient.window = clients[sel]->win;
-		ev.xclient.message_type = wmatom[WMProtocols];
-		ev.xclient.format = 32;
-		ev.xclient.data.l[0] = wmatom[WMDelete];
-		ev.xclient.data.l[1] = CurrentTime;
-		XSendEvent(dpy, clients[sel]->win, False, NoEventMask, &ev);
-		clients[sel]->closed = True;
-	} else {
-		XKillClient(dpy, clients[sel]->win);
-	}
+	closeclient(sel);
 }
 
 void
@@ -871,7 +1390,11 @@ manage(Window w)
 		XEvent e;
 
 		XWithdrawWindow(dpy, w, 0);
+		#if SIDEBAR_PATCH
+		XReparentWindow(dpy, w, win, sidebarright ? 0 : sidebarwidth, 0);
+		#else
 		XReparentWindow(dpy, w, win, 0, bh);
+		#endif // SIDEBAR_PATCH
 		XSelectInput(dpy, w, PropertyChangeMask |
 		             StructureNotifyMask | EnterWindowMask);
 		XSync(dpy, False);
@@ -908,6 +1431,12 @@ manage(Window w)
 
 		c = ecalloc(1, sizeof *c);
 		c->win = w;
+		#if ICON_PATCH
+		c->icondirty = True;
+		#endif // ICON_PATCH
+		#if TABICONS_PATCH
+		tabiconschedule(c);
+		#endif // TABICONS_PATCH
 
 		nclients++;
 		clients = erealloc(clients, sizeof(Client *) * nclients);
@@ -930,7 +1459,27 @@ manage(Window w)
 			        sizeof(Client *) * (nclients - nextpos - 1));
 
 		clients[nextpos] = c;
+		#if CLIENTLIST_PATCH
+		clientsdirty = True;
+		#endif // CLIENTLIST_PATCH
+		#if FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+		fallbacktitles(nextpos + 1, nclients);
+		#endif // FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
 		updatetitle(nextpos);
+		#if PROPCACHE_PATCH
+		propfetch(nextpos);
+		#elif WORKER_PATCH
+		workerpost(JobProtocols, nextpos);
+		#endif // PROPCACHE_PATCH
+		#if PROCSTATS_PATCH
+		procclaim(nextpos);
+		#endif // PROCSTATS_PATCH
+		#if SUPERVISE_PATCH
+		supervisetie(nextpos);
+		#endif // SUPERVISE_PATCH
+		#if DAMAGEWATCH
+		damagemanage(c);
+		#endif // DAMAGEWATCH
 
 		XLowerWindow(dpy, w);
 		XMapWindow(dpy, w);
@@ -978,7 +1527,9 @@ void
 movetab(const Arg *arg)
 {
 	int c;
+	#if !IPC_PATCH
 	Client *new;
+	#endif // !IPC_PATCH
 
 	if (sel < 0)
 		return;
@@ -990,6 +1541,9 @@ movetab(const Arg *arg)
 	if (c == sel)
 		return;
 
+	#if IPC_PATCH
+	ipcmovetab(sel, c);
+	#else
 	new = clients[sel];
 	if (sel < c)
 		memmove(&clients[sel], &clients[sel+1],
@@ -998,9 +1552,108 @@ movetab(const Arg *arg)
 		memmove(&clients[c+1], &clients[c],
 		        sizeof(Client *) * (sel - c));
 	clients[c] = new;
+	#if FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	fallbacktitles(MIN(sel, c), MAX(sel, c) + 1);
+	#endif // FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
 	sel = c;
+	#if CLIENTLIST_PATCH
+	clientsdirty = titlesdirty = True;
+	#endif // CLIENTLIST_PATCH
 
 	drawbar();
+	#endif // IPC_PATCH
+}
+
+/* Parses the command line into the settings of tabbed. */
+void
+parseargs(int argc, char *argv[], Bool *detach)
+{
+	int replace = 0;
+	char *pstr;
+
+	ARGBEGIN {
+	case 'c':
+		closelastclient = True;
+		fillagain = False;
+		break;
+	case 'd':
+		*detach = True;
+		break;
+	case 'f':
+		fillagain = True;
+		break;
+	case 'g':
+		geometry = EARGF(usage());
+		break;
+	case 'k':
+		killclientsfirst = True;
+		break;
+	case 'n':
+		wmname = EARGF(usage());
+		break;
+	case 'O':
+		normfgcolor = EARGF(usage());
+		break;
+	case 'o':
+		normbgcolor = EARGF(usage());
+		break;
+	case 'p':
+		pstr = EARGF(usage());
+		if (pstr[0] == 's') {
+			npisrelative = True;
+			newposition = atoi(&pstr[1]);
+		} else {
+			newposition = atoi(pstr);
+		}
+		break;
+	case 'r':
+		replace = atoi(EARGF(usage()));
+		break;
+	case 's':
+		doinitspawn = False;
+		break;
+	case 'T':
+		selfgcolor = EARGF(usage());
+		break;
+	case 't':
+		selbgcolor = EARGF(usage());
+		break;
+	case 'U':
+		urgfgcolor = EARGF(usage());
+		break;
+	case 'u':
+		urgbgcolor = EARGF(usage());
+		break;
+	#if BASENAME_PATCH
+	case 'b':
+		basenametitles = True;
+		break;
+	#endif // BASENAME_PATCH
+	#if FASTSTARTUP_PATCH
+	case 'B':
+		showstartup = True;
+		break;
+	#endif // FASTSTARTUP_PATCH
+	#if EVENTPRIORITY_PATCH
+	case 'L':
+		showlatency = True;
+		break;
+	#endif // EVENTPRIORITY_PATCH
+	case 'v':
+		die("tabbed-"VERSION", © 2009-2016 tabbed engineers, "
+		    "see LICENSE for details.\n");
+		break;
+	default:
+		usage();
+		break;
+	} ARGEND;
+
+	if (argc < 1) {
+		doinitspawn = False;
+		fillagain = False;
+	}
+
+	setcmd(argc, argv, replace);
 }
 
 void
@@ -1012,6 +1665,23 @@ propertynotify(const XEvent *e)
 	char* selection = NULL;
 	Arg arg;
 
+	#if XRESOURCES_PATCH && XRESOURCES_RELOAD_PATCH
+	if (ev->window == root) {
+		if (ev->atom == XA_RESOURCE_MANAGER)
+			xrdb_reload();
+		return;
+	}
+	#endif // XRESOURCES_RELOAD_PATCH
+	#if PROPCACHE_PATCH
+	propinvalidate(ev);
+	#endif // PROPCACHE_PATCH
+	#if FULLSCREENBYPASS_PATCH
+	if (ev->window == win && ev->atom == wmatom[WMState]) {
+		fullscreenstate();
+		return;
+	}
+	#endif // FULLSCREENBYPASS_PATCH
+
 	if (ev->state == PropertyNewValue && ev->atom == wmatom[WMSelectTab]) {
 		selection = getatom(WMSelectTab);
 		if (!strncmp(selection, "0x", 2)) {
@@ -1020,47 +1690,38 @@ propertynotify(const XEvent *e)
 		} else {
 			cmd[cmd_append_pos] = selection;
 			arg.v = cmd;
-			spawn(&arg);
+			spawnchild(&arg, True);
 		}
 	} else if (ev->state == PropertyNewValue && ev->atom == XA_WM_HINTS &&
-	           (c = getclient(ev->window)) > -1 &&
-	           (wmh = XGetWMHints(dpy, clients[c]->win))) {
-		if (wmh->flags & XUrgencyHint) {
+	           (c = getclient(ev->window)) > -1) {
+		#if WORKER_PATCH
+		if (workerpost(JobHints, c))
+			return;
+		#endif // WORKER_PATCH
+		#if PROPCACHE_PATCH
+		if ((wmh = gethints(c))) {
+		#else
+		if ((wmh = XGetWMHints(dpy, clients[c]->win))) {
+		#endif // PROPCACHE_PATCH
+			updatewmhints(c, wmh);
 			XFree(wmh);
-			wmh = XGetWMHints(dpy, win);
-			if (c != sel) {
-				if (urgentswitch && wmh &&
-				    !(wmh->flags & XUrgencyHint)) {
-					/* only switch, if tabbed was focused
-					 * since last urgency hint if WMHints
-					 * could not be received,
-					 * default to no switch */
-					focus(c);
-				} else {
-					/* if no switch should be performed,
-					 * mark tab as urgent */
-					clients[c]->urgent = True;
-					drawbar();
-				}
-			}
-			if (wmh && !(wmh->flags & XUrgencyHint)) {
-				/* update tabbed urgency hint
-				 * if not set already */
-				wmh->flags |= XUrgencyHint;
-				XSetWMHints(dpy, win, wmh);
-			}
 		}
-		XFree(wmh);
-		#if ICON_PATCH
-		if (c == sel)
-			xseticon();
-		#endif // ICON_PATCH
 	} else if (ev->state != PropertyDelete && ev->atom == XA_WM_NAME &&
 	           (c = getclient(ev->window)) > -1) {
 		updatetitle(c);
+	#if WORKER_PATCH
+	} else if (ev->atom == wmatom[WMProtocols] && (c = getclient(ev->window)) > -1) {
+		clients[c]->protoknown = False;
+		workerpost(JobProtocols, c);
+	#endif // WORKER_PATCH
 	#if ICON_PATCH
-	} else if (ev->atom == wmatom[WMIcon] && (c = getclient(ev->window)) > -1 && c == sel) {
-		xseticon();
+	} else if (ev->atom == wmatom[WMIcon] && (c = getclient(ev->window)) > -1) {
+		clients[c]->icondirty = True;
+		if (c == sel)
+			xseticon();
+		#if TABICONS_PATCH
+		tabiconschedule(clients[c]);
+		#endif // TABICONS_PATCH
 	#endif // ICON_PATCH
 	}
 }
@@ -1071,12 +1732,26 @@ resize(int c, int w, int h)
 	XConfigureEvent ce;
 	XWindowChanges wc;
 
+	#if SIDEBAR_PATCH
+	/* clients sit next to the sidebar, not below the bar */
+	ce.x = wc.x = sidebarright ? 0 : sidebarwidth;
+	ce.y = wc.y = 0;
+	w = MAX(1, ww - sidebarwidth);
+	h = wh;
+	#if FULLSCREENBYPASS_PATCH
+	if (fullscreened) {
+		ce.x = wc.x = 0;
+		w = ww;
+	}
+	#endif // FULLSCREENBYPASS_PATCH
+	#else
 	ce.x = 0;
 	#if BOTTOM_TABS_PATCH
 	ce.y = wc.y = 0;
 	#else
 	ce.y = wc.y = bh;
 	#endif // BOTTOM_TABS_PATCH
+	#endif // SIDEBAR_PATCH
 	ce.width = wc.width = w;
 	ce.height = wc.height = h;
 	ce.type = ConfigureNotify;
@@ -1087,7 +1762,11 @@ resize(int c, int w, int h)
 	ce.override_redirect = False;
 	ce.border_width = 0;
 
+	#if SIDEBAR_PATCH
+	XConfigureWindow(dpy, clients[c]->win, CWX | CWY | CWWidth | CWHeight, &wc);
+	#else
 	XConfigureWindow(dpy, clients[c]->win, CWY | CWWidth | CWHeight, &wc);
+	#endif // SIDEBAR_PATCH
 	XSendEvent(dpy, clients[c]->win, False, StructureNotifyMask,
 	           (XEvent *)&ce);
 }
@@ -1117,19 +1796,66 @@ rotate(const Arg *arg)
 void
 run(void)
 {
+	#if !EVENTPRIORITY_PATCH
 	XEvent ev;
+	#endif // EVENTPRIORITY_PATCH
+
+	#if WORKER_PATCH
+	/* not in setup(), the thread would not survive the fork of -d */
+	workerinit();
+	#endif // WORKER_PATCH
 
 	/* main event loop */
 	XSync(dpy, False);
 	drawbar();
+	#if FASTSTARTUP_PATCH
+	startupmark("first frame");
+	startupreport();
+	#endif // FASTSTARTUP_PATCH
 	if (doinitspawn == True)
 		spawn(NULL);
 
+	#if EVENTPRIORITY_PATCH
+	while (running) {
+		schedevents();
+		if (running)
+			waitevents();
+	}
+	#elif EVENTLOOP
+	while (running) {
+		while (running && XPending(dpy)) {
+			XNextEvent(dpy, &ev);
+			#if DAMAGEWATCH
+			if (isdamageevent(&ev))
+				damagenotify(&ev);
+			else
+			#endif // DAMAGEWATCH
+			#if FRAMEPACE_PATCH
+			if (israndrevent(&ev))
+				randrnotify(&ev);
+			else
+			#endif // FRAMEPACE_PATCH
+			if (handler[ev.type])
+				(handler[ev.type])(&ev); /* call handler */
+			#if POINTERCOMPRESS_PATCH
+			pointersettle();
+			#endif // POINTERCOMPRESS_PATCH
+		}
+		if (running)
+			waitevents();
+	}
+	#else
 	while (running) {
 		XNextEvent(dpy, &ev);
+		#if DAMAGEWATCH
+		if (isdamageevent(&ev))
+			damagenotify(&ev);
+		else
+		#endif // DAMAGEWATCH
 		if (handler[ev.type])
 			(handler[ev.type])(&ev); /* call handler */
 	}
+	#endif // EVENTLOOP
 }
 
 void
@@ -1167,16 +1893,19 @@ setcmd(int argc, char *argv[], int replace)
 void
 setup(void)
 {
-	int bitm, tx, ty, tw, th, dh, dw, isfixed;
-	XWMHints *wmh;
-	XClassHint class_hint;
-	XSizeHints *size_hint;
 	struct sigaction sa;
 
 	/* do not transform children into zombies when they terminate */
 	sigemptyset(&sa.sa_mask);
 	sa.sa_flags = SA_NOCLDSTOP | SA_NOCLDWAIT | SA_RESTART;
 	sa.sa_handler = SIG_IGN;
+	#if SUPERVISE_PATCH
+	/* unless they are reaped through their pidfd */
+	if (superviseinit()) {
+		sa.sa_flags &= ~SA_NOCLDWAIT;
+		sa.sa_handler = SIG_DFL;
+	}
+	#endif // SUPERVISE_PATCH
 	sigaction(SIGCHLD, &sa, NULL);
 
 	/* clean up any zombies that might have been inherited */
@@ -1186,6 +1915,9 @@ setup(void)
 	screen = DefaultScreen(dpy);
 	root = RootWindow(dpy, screen);
 	initfont(font);
+	#if FASTSTARTUP_PATCH
+	startupmark("font");
+	#endif // FASTSTARTUP_PATCH
 	#if BAR_HEIGHT_PATCH
 	dc.h = (barheight ? barheight : dc.font.height + 2);
 	#else
@@ -1197,18 +1929,73 @@ setup(void)
 	bh = dc.h;
 	#endif // AUTOHIDE_PATCH | HIDETABS_PATCH
 
-	/* init atoms */
-	wmatom[WMDelete] = XInternAtom(dpy, "WM_DELETE_WINDOW", False);
-	wmatom[WMFullscreen] = XInternAtom(dpy, "_NET_WM_STATE_FULLSCREEN",
-	                                   False);
-	wmatom[WMName] = XInternAtom(dpy, "_NET_WM_NAME", False);
-	wmatom[WMProtocols] = XInternAtom(dpy, "WM_PROTOCOLS", False);
-	wmatom[WMSelectTab] = XInternAtom(dpy, "_TABBED_SELECT_TAB", False);
-	wmatom[WMState] = XInternAtom(dpy, "_NET_WM_STATE", False);
-	wmatom[XEmbed] = XInternAtom(dpy, "_XEMBED", False);
+	/* init atoms, all in a single round trip */
+	XInternAtoms(dpy, atomnames, WMLast, False, wmatom);
+	#if FASTSTARTUP_PATCH
+	startupmark("atoms");
+	#endif // FASTSTARTUP_PATCH
+
+	#if ALPHA_PATCH
+	XVisualInfo *vis;
+	XRenderPictFormat *fmt;
+	int nvi;
+	int i;
+
+	XVisualInfo tpl = {
+		.screen = screen,
+		.depth = 32,
+		.class = TrueColor
+	};
+
+	vis = XGetVisualInfo(dpy, VisualScreenMask | VisualDepthMask | VisualClassMask, &tpl, &nvi);
+	for(i = 0; i < nvi; i ++) {
+		fmt = XRenderFindVisualFormat(dpy, vis[i].visual);
+		if (fmt->type == PictTypeDirect && fmt->direct.alphaMask) {
+			visual = vis[i].visual;
+			break;
+		}
+	}
+
+	XFree(vis);
+
+	if (! visual) {
+		fprintf(stderr, "Couldn't find ARGB visual.\n");
+		exit(1);
+	}
+
+	cmap = XCreateColormap( dpy, root, visual, None);
+	#endif // ALPHA_PATCH
+
+	#if XRESOURCES_PATCH && XRESOURCES_RELOAD_PATCH
+	XSelectInput(dpy, root, PropertyChangeMask);
+	#endif // XRESOURCES_RELOAD_PATCH
+	xerrorxlib = XSetErrorHandler(xerror);
+	#if FRAMEPACE_PATCH
+	frameinit();
+	#endif // FRAMEPACE_PATCH
+
 	#if ICON_PATCH
-	wmatom[WMIcon] = XInternAtom(dpy, "_NET_WM_ICON", False);
+	/* change icon from RGBA to ARGB */
+	icon[0] = ICON_WIDTH;
+	icon[1] =  ICON_HEIGHT;
+	for (int i = 0; i < ICON_WIDTH * ICON_HEIGHT; ++i) {
+		icon[i + 2] =
+			ICON_PIXEL_DATA[i * 4 + 3] << 24 |
+			ICON_PIXEL_DATA[i * 4 + 0] <<  0 |
+			ICON_PIXEL_DATA[i * 4 + 1] <<  8 |
+			ICON_PIXEL_DATA[i * 4 + 2] << 16 ;
+	}
 	#endif // ICON_PATCH
+}
+
+/* Creates the window of tabbed. */
+void
+setupwin(void)
+{
+	int bitm, tx, ty, tw, th, dh, dw, isfixed;
+	XWMHints *wmh;
+	XClassHint class_hint;
+	XSizeHints *size_hint;
 
 	/* init appearance */
 	wx = 0;
@@ -1244,43 +2031,15 @@ setup(void)
 			wy = dh + wy - wh - 1;
 	}
 
-	#if ALPHA_PATCH
-	XVisualInfo *vis;
-	XRenderPictFormat *fmt;
-	int nvi;
-	int i;
-
-	XVisualInfo tpl = {
-		.screen = screen,
-		.depth = 32,
-		.class = TrueColor
-	};
-
-	vis = XGetVisualInfo(dpy, VisualScreenMask | VisualDepthMask | VisualClassMask, &tpl, &nvi);
-	for(i = 0; i < nvi; i ++) {
-		fmt = XRenderFindVisualFormat(dpy, vis[i].visual);
-		if (fmt->type == PictTypeDirect && fmt->direct.alphaMask) {
-			visual = vis[i].visual;
-			break;
-		}
-	}
-
-	XFree(vis);
-
-	if (! visual) {
-		fprintf(stderr, "Couldn't find ARGB visual.\n");
-		exit(1);
-	}
-
-	cmap = XCreateColormap( dpy, root, visual, None);
-	#endif // ALPHA_PATCH
-
 	dc.norm[ColBG] = getcolor(normbgcolor);
 	dc.norm[ColFG] = getcolor(normfgcolor);
 	dc.sel[ColBG] = getcolor(selbgcolor);
 	dc.sel[ColFG] = getcolor(selfgcolor);
 	dc.urg[ColBG] = getcolor(urgbgcolor);
 	dc.urg[ColFG] = getcolor(urgfgcolor);
+	#if FASTSTARTUP_PATCH
+	startupmark("colors");
+	#endif // FASTSTARTUP_PATCH
 	#if ALPHA_PATCH
 	XSetWindowAttributes attrs;
 	attrs.background_pixel = dc.norm[ColBG].pixel;
@@ -1297,15 +2056,29 @@ setup(void)
 		| CWEventMask | CWColormap, &attrs);
 
 	dc.drawable = XCreatePixmap(dpy, win, ww, wh, 32);
-	dc.gc = XCreateGC(dpy, dc.drawable, 0, 0);
+	if (!dc.gc)
+		dc.gc = XCreateGC(dpy, dc.drawable, 0, 0);
 	#else
 	dc.drawable = XCreatePixmap(dpy, root, ww, wh,
 	                            DefaultDepth(dpy, screen));
-	dc.gc = XCreateGC(dpy, root, 0, 0);
+	if (!dc.gc)
+		dc.gc = XCreateGC(dpy, root, 0, 0);
 
 	win = XCreateSimpleWindow(dpy, root, wx, wy, ww, wh, 0,
 	                          dc.norm[ColFG].pixel, dc.norm[ColBG].pixel);
 	#endif // ALPHA_PATCH
+	#if RASTER_PATCH
+	rasterinit();
+	#endif // RASTER_PATCH
+	#if DAMAGEWATCH
+	damageinit();
+	#endif // DAMAGEWATCH
+	#if OVERVIEW_PATCH
+	overviewinit();
+	#endif // OVERVIEW_PATCH
+	#if FRAMEPACE_PATCH
+	frameoutput();
+	#endif // FRAMEPACE_PATCH
 	XMapRaised(dpy, win);
 	XSelectInput(dpy, win, SubstructureNotifyMask | FocusChangeMask |
 	             ButtonPressMask | ExposureMask | KeyPressMask |
@@ -1316,8 +2089,10 @@ setup(void)
 	             #if DRAG_PATCH
 	             ButtonMotionMask |
 	             #endif // DRAG_PATCH
+	             #if DRAG_PATCH && POINTERCOMPRESS_PATCH
+	             ButtonReleaseMask |
+	             #endif // DRAG_PATCH && POINTERCOMPRESS_PATCH
 	             SubstructureRedirectMask);
-	xerrorxlib = XSetErrorHandler(xerror);
 
 	class_hint.res_name = wmname;
 	class_hint.res_class = "tabbed";
@@ -1329,6 +2104,9 @@ setup(void)
 		size_hint->height = wh;
 		size_hint->width = ww;
 		size_hint->min_height = bh + 1;
+		#if SIDEBAR_PATCH
+		size_hint->min_width = sidebarwidth + 1;
+		#endif // SIDEBAR_PATCH
 	} else {
 		size_hint->flags = PMaxSize | PMinSize;
 		size_hint->min_width = size_hint->max_width = ww;
@@ -1343,30 +2121,37 @@ setup(void)
 
 	snprintf(winid, sizeof(winid), "%lu", win);
 	setenv("XEMBED", winid, 1);
-
-	#if ICON_PATCH
-	/* change icon from RGBA to ARGB */
-	icon[0] = ICON_WIDTH;
-	icon[1] =  ICON_HEIGHT;
-	for (int i = 0; i < ICON_WIDTH * ICON_HEIGHT; ++i) {
-		icon[i + 2] =
-			ICON_PIXEL_DATA[i * 4 + 3] << 24 |
-			ICON_PIXEL_DATA[i * 4 + 0] <<  0 |
-			ICON_PIXEL_DATA[i * 4 + 1] <<  8 |
-			ICON_PIXEL_DATA[i * 4 + 2] << 16 ;
-	}
-	#endif // ICON_PATCH
+	#if IPC_PATCH
+	ipcinit();
+	#endif // IPC_PATCH
 
 	nextfocus = foreground;
 	focus(-1);
+	#if FASTSTARTUP_PATCH
+	startupmark("window");
+	#endif // FASTSTARTUP_PATCH
 }
 
 void
 spawn(const Arg *arg)
+{
+	/* a binding with a command of its own runs a helper, not a tab */
+	spawnchild(arg, !(arg && arg->v));
+}
+
+/* Runs the command in arg, or the tab command if there is none. tab tells
+ * whether the command is expected to embed a new tab. */
+void
+spawnchild(const Arg *arg, Bool tab)
 {
 	struct sigaction sa;
+	#if PROCSTATS_PATCH || SUPERVISE_PATCH
+	pid_t pid;
 
+	if ((pid = fork()) == 0) {
+	#else
 	if (fork() == 0) {
+	#endif // PROCSTATS_PATCH | SUPERVISE_PATCH
 		if(dpy)
 			close(ConnectionNumber(dpy));
 
@@ -1376,6 +2161,9 @@ spawn(const Arg *arg)
 		sa.sa_flags = 0;
 		sa.sa_handler = SIG_DFL;
 		sigaction(SIGCHLD, &sa, NULL);
+		#if DAEMONSHARED
+		daemonchild();
+		#endif // DAEMONSHARED
 
 		if (arg && arg->v) {
 			execvp(((char **)arg->v)[0], (char **)arg->v);
@@ -1389,14 +2177,28 @@ spawn(const Arg *arg)
 		perror(" failed");
 		exit(0);
 	}
+	#if PROCSTATS_PATCH
+	if (pid > 0 && tab)
+		procspawned(pid);
+	#endif // PROCSTATS_PATCH
+	#if SUPERVISE_PATCH
+	if (pid > 0)
+		supervisespawned(pid, tab);
+	#endif // SUPERVISE_PATCH
 }
 
 int
 textnw(const char *text, unsigned int len)
 {
+	#if FONTFALLBACK_PATCH
+	return runswidth(textruns(text, len), len);
+	#elif RASTER_PATCH
+	return render->textw(text, len);
+	#else
 	XGlyphInfo ext;
 	XftTextExtentsUtf8(dpy, dc.font.xfont, (XftChar8 *) text, len, &ext);
 	return ext.xOff;
+	#endif // RASTER_PATCH
 }
 
 void
@@ -1417,23 +2219,30 @@ unmanage(int c)
 	if (!nclients)
 		return;
 
+	freeclient(clients[c]);
 	if (c == 0) {
 		/* First client. */
 		nclients--;
-		free(clients[0]);
 		memmove(&clients[0], &clients[1], sizeof(Client *) * nclients);
 	} else if (c == nclients - 1) {
 		/* Last client. */
 		nclients--;
-		free(clients[c]);
 		clients = erealloc(clients, sizeof(Client *) * nclients);
 	} else {
 		/* Somewhere inbetween. */
-		free(clients[c]);
 		memmove(&clients[c], &clients[c+1],
 		        sizeof(Client *) * (nclients - (c + 1)));
 		nclients--;
 	}
+	#if FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	fallbacktitles(c, nclients);
+	#endif // FONTFALLBACK_PATCH && CLIENTNUMBER_PATCH
+	#if CLIENTLIST_PATCH
+	clientsdirty = titlesdirty = True;
+	#endif // CLIENTLIST_PATCH
+	#if SWITCHER_PATCH
+	switcherupdate(-1);
+	#endif // SWITCHER_PATCH
 
 	if (nclients <= 0) {
 		lastsel = sel = -1;
@@ -1450,6 +2259,12 @@ unmanage(int c)
 
 		if (c == sel && lastsel >= 0) {
 			focus(lastsel);
+		#if BULKOPS_PATCH
+		} else if (c != sel) {
+			/* the selected tab stays, it only needs to be redrawn */
+			if (sel > c)
+				sel--;
+		#endif // BULKOPS_PATCH
 		} else {
 			if (sel > c)
 				sel--;
@@ -1470,8 +2285,12 @@ unmapnotify(const XEvent *e)
 	const XUnmapEvent *ev = &e->xunmap;
 	int c;
 
-	if ((c = getclient(ev->window)) > -1)
+	if ((c = getclient(ev->window)) > -1) {
+		#if SUPERVISE_PATCH
+		supervisegone(ev->window);
+		#endif // SUPERVISE_PATCH
 		unmanage(c);
+	}
 }
 
 void
@@ -1495,19 +2314,113 @@ updatenumlockmask(void)
 void
 updatetitle(int c)
 {
-	if (!gettextprop(clients[c]->win, wmatom[WMName], clients[c]->name,
+	#if IPC_PATCH
+	if (clients[c]->fixedtitle)
+		return;
+	#endif // IPC_PATCH
+	#if FULLSCREENBYPASS_PATCH
+	/* fetched once fullscreen ends */
+	if (fullscreened && c != sel) {
+		clients[c]->titlestale = True;
+		return;
+	}
+	clients[c]->titlestale = False;
+	#endif // FULLSCREENBYPASS_PATCH
+	#if LAZYTITLES_PATCH
+	if (!titlewanted(c)) {
+		clients[c]->titlestale = True;
+		return;
+	}
+	clients[c]->titlestale = False;
+	#endif // LAZYTITLES_PATCH
+	#if WORKER_PATCH
+	if (workertitle) {
+		/* fetched by the worker */
+		snprintf(clients[c]->name, sizeof(clients[c]->name), "%s", workertitle);
+	} else if (workerpost(JobTitle, c)) {
+		return;
+	} else
+	#endif // WORKER_PATCH
+	if (!gettextprop(dpy, clients[c]->win, wmatom[WMName], clients[c]->name,
 	    sizeof(clients[c]->name)))
-		gettextprop(clients[c]->win, XA_WM_NAME, clients[c]->name,
+		gettextprop(dpy, clients[c]->win, XA_WM_NAME, clients[c]->name,
 		            sizeof(clients[c]->name));
 	#if BASENAME_PATCH
 	if (basenametitles)
 		clients[c]->basename = getbasename(clients[c]->name);
 	#endif // BASENAME_PATCH
+	#if CLIENTLIST_PATCH
+	titlesdirty = True;
+	#endif // CLIENTLIST_PATCH
+	#if FITTABS_PATCH
+	layouttitle(c);
+	#endif // FITTABS_PATCH
+	#if FONTFALLBACK_PATCH
+	fallbacktitle(c);
+	#endif // FONTFALLBACK_PATCH
+	#if SWITCHER_PATCH
+	switcherupdate(c);
+	#endif // SWITCHER_PATCH
 	if (sel == c)
 		xsettitle(win, clients[c]->name);
 	drawbar();
 }
 
+void
+updatewmhints(int c, XWMHints *wmh)
+{
+	XWMHints *winwmh;
+
+	#if ICON_PATCH
+	/* the legacy icon only matters when there is no _NET_WM_ICON */
+	if (!clients[c]->icon && clients[c]->iconpixmap !=
+	    (wmh->flags & IconPixmapHint ? wmh->icon_pixmap : None)) {
+		clients[c]->icondirty = True;
+		#if TABICONS_PATCH
+		tabiconschedule(clients[c]);
+		#endif // TABICONS_PATCH
+	}
+	#endif // ICON_PATCH
+	if (wmh->flags & XUrgencyHint) {
+		#if PROPCACHE_PATCH
+		winwmh = gethints(-1);
+		#else
+		winwmh = XGetWMHints(dpy, win);
+		#endif // PROPCACHE_PATCH
+		if (c != sel) {
+			if (urgentswitch && winwmh &&
+			    !(winwmh->flags & XUrgencyHint)) {
+				/* only switch, if tabbed was focused
+				 * since last urgency hint if WMHints
+				 * could not be received,
+				 * default to no switch */
+				focus(c);
+			} else {
+				/* if no switch should be performed,
+				 * mark tab as urgent */
+				clients[c]->urgent = True;
+				drawbar();
+			}
+		}
+		if (winwmh && !(winwmh->flags & XUrgencyHint)) {
+			/* update tabbed urgency hint
+			 * if not set already */
+			winwmh->flags |= XUrgencyHint;
+			#if PROPCACHE_PATCH
+			sethints(-1, winwmh);
+			#else
+			XSetWMHints(dpy, win, winwmh);
+			#endif // PROPCACHE_PATCH
+		}
+		if (winwmh)
+			XFree(winwmh);
+	}
+	#if ICON_PATCH
+	if (c == sel && clients[c]->icondirty)
+		xseticon();
+	#endif // ICON_PATCH
+}
+
 /* There's no way to check accesses to destroyed windows, thus those cases are
  * ignored (especially on UnmapNotify's).  Other types of errors call Xlibs
  * default error handler, which may call exit.  */
@@ -1530,7 +2443,14 @@ xerror(Display *dpy, XErrorEvent *ee)
 	    || (ee->request_code == X_GrabKey &&
 	        ee->error_code == BadAccess)
 	    || (ee->request_code == X_CopyArea &&
-	        ee->error_code == BadDrawable))
+	        ee->error_code == BadDrawable)
+	    #if DAMAGEWATCH
+	    || damageerror(ee)
+	    #endif // DAMAGEWATCH
+	    #if OVERVIEW_PATCH
+	    || overviewerror(ee)
+	    #endif // OVERVIEW_PATCH
+	    )
 		return 0;
 
 	fprintf(stderr, "%s: fatal error: request code=%d, error code=%d\n",
@@ -1554,11 +2474,22 @@ xsettitle(Window w, const char *str)
 void
 usage(void)
 {
-	die("usage: %s [-"
+	die("usage: %s "
+		#if DAEMON_PATCH
+		"[-D | -a] "
+		#endif // DAEMON_PATCH
+		"[-"
+		#if FASTSTARTUP_PATCH
+		"B"
+		#endif // FASTSTARTUP_PATCH
 		#if BASENAME_PATCH
 		"b"
 		#endif // BASENAME_PATCH
-		"dfksv] [-g geometry] [-n name] [-p [s+/-]pos]\n"
+		"dfk"
+		#if EVENTPRIORITY_PATCH
+		"L"
+		#endif // EVENTPRIORITY_PATCH
+		"sv] [-g geometry] [-n name] [-p [s+/-]pos]\n"
 	    "       [-r narg] [-o color] [-O color] [-t color] [-T color]\n"
 	    "       [-u color] [-U color] command...\n", argv0);
 }
@@ -1567,95 +2498,62 @@ int
 main(int argc, char *argv[])
 {
 	Bool detach = False;
-	int replace = 0;
-	char *pstr;
-
-	ARGBEGIN {
-	case 'c':
-		closelastclient = True;
-		fillagain = False;
-		break;
-	case 'd':
-		detach = True;
-		break;
-	case 'f':
-		fillagain = True;
-		break;
-	case 'g':
-		geometry = EARGF(usage());
-		break;
-	case 'k':
-		killclientsfirst = True;
-		break;
-	case 'n':
-		wmname = EARGF(usage());
-		break;
-	case 'O':
-		normfgcolor = EARGF(usage());
-		break;
-	case 'o':
-		normbgcolor = EARGF(usage());
-		break;
-	case 'p':
-		pstr = EARGF(usage());
-		if (pstr[0] == 's') {
-			npisrelative = True;
-			newposition = atoi(&pstr[1]);
-		} else {
-			newposition = atoi(pstr);
-		}
-		break;
-	case 'r':
-		replace = atoi(EARGF(usage()));
-		break;
-	case 's':
-		doinitspawn = False;
-		break;
-	case 'T':
-		selfgcolor = EARGF(usage());
-		break;
-	case 't':
-		selbgcolor = EARGF(usage());
-		break;
-	case 'U':
-		urgfgcolor = EARGF(usage());
-		break;
-	case 'u':
-		urgbgcolor = EARGF(usage());
-		break;
-	#if BASENAME_PATCH
-	case 'b':
-		basenametitles = True;
-		break;
-	#endif // BASENAME_PATCH
-	case 'v':
-		die("tabbed-"VERSION", © 2009-2016 tabbed engineers, "
-		    "see LICENSE for details.\n");
-		break;
-	default:
-		usage();
-		break;
-	} ARGEND;
-
-	if (argc < 1) {
-		doinitspawn = False;
-		fillagain = False;
+	#if DAEMON_PATCH
+	char **request = NULL;
+	#endif // DAEMON_PATCH
+
+	#if WORKER_PATCH
+	XInitThreads();
+	#endif // WORKER_PATCH
+	#if DAEMON_PATCH
+	argv0 = argv[0];
+	if (argc > 1 && !strcmp(argv[1], "-D")) {
+		/* only returns in a new container */
+		daemonserve(&argc, &argv);
+	} else if (argc > 1 && !strcmp(argv[1], "-a")) {
+		argv[1] = argv[0];
+		argc--;
+		argv++;
+		/* the arguments are checked here first, parseargs() consumes them */
+		request = ecalloc(argc + 1, sizeof(char *));
+		memcpy(request, argv, argc * sizeof(char *));
 	}
-
-	setcmd(argc, argv, replace);
+	#endif // DAEMON_PATCH
+	#if FASTSTARTUP_PATCH
+	startupmark("start");
+	#endif // FASTSTARTUP_PATCH
+
+	parseargs(argc, argv, &detach);
+	#if DAEMON_PATCH
+	/* only returns if there is no daemon to ask */
+	if (request)
+		daemonclient(request + 1);
+	#endif // DAEMON_PATCH
 
 	if (!setlocale(LC_CTYPE, "") || !XSupportsLocale())
 		fprintf(stderr, "%s: no locale support\n", argv0);
 	if (!(dpy = XOpenDisplay(NULL)))
 		die("%s: cannot open display\n", argv0);
+	#if FASTSTARTUP_PATCH
+	startupmark("display");
+	#endif // FASTSTARTUP_PATCH
 
 	#if XRESOURCES_PATCH
 	config_init();
 	#if XRESOURCES_RELOAD_PATCH
-	signal(SIGUSR1, xrdb_reload);
+	/* reloading follows RESOURCE_MANAGER, do not die on the old reload signal */
+	signal(SIGUSR1, SIG_IGN);
 	#endif // XRESOURCES_RELOAD_PATCH
 	#endif // XRESOURCES_PATCH
+	#if FASTSTARTUP_PATCH
+	startupmark("resources");
+	#endif // FASTSTARTUP_PATCH
 	setup();
+	setupwin();
+	#if DAEMON_PATCH && !DAEMONSHARED
+	/* a container of the daemon hands its window id to the caller instead */
+	if (!daemonreply())
+	#endif // DAEMON_PATCH
 	printf("0x%lx\n", win);
 	fflush(NULL);
 
@@ -1670,6 +2568,7 @@ main(int argc, char *argv[])
 	}
 
 	run();
+	cleanupwin();
 	cleanup();
 	XCloseDisplay(dpy);
 